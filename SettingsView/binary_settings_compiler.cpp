@@ -0,0 +1,228 @@
+#include "pch.h"
+
+#include "binary_settings_compiler.h"
+
+#include "binary_settings_format.h"
+#include "memory_mapped_file.h"
+#include "settings_path.h"
+#include "utils.h"
+
+#include <rapidjson/error/en.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct leaf final
+    {
+        std::string key;
+        std::uint64_t keyHash;
+        const rapidjson::Value* value;
+    };
+
+    //! Appends an entry for every leaf value of \p value, \p key is the key of the \p value itself
+    void flatten(const rapidjson::Value& value, const std::string& key, std::vector<leaf>& leaves)
+    {
+        const auto childKey = [&key](const std::string& escapedName) {
+            return key.empty() ? escapedName : key + settings_path::separator + escapedName;
+        };
+
+        if (value.IsObject())
+        {
+            for (auto memberIt = value.MemberBegin(); memberIt != value.MemberEnd(); ++memberIt)
+            {
+                const std::string_view name(memberIt->name.GetString(), memberIt->name.GetStringLength());
+                flatten(memberIt->value, childKey(settings_path::escape(name)), leaves);
+            }
+            return;
+        }
+
+        if (value.IsArray())
+        {
+            // the array of numbers is readable as a whole as well
+            if (std::all_of(value.Begin(), value.End(), [](const rapidjson::Value& item) { return item.IsNumber(); }))
+            {
+                leaves.push_back(leaf{key, fnv1a_64(key), &value});
+            }
+
+            for (rapidjson::SizeType i = 0; i < value.Size(); ++i)
+            {
+                flatten(value[i], childKey(std::to_string(i)), leaves);
+            }
+            return;
+        }
+
+        leaves.push_back(leaf{key, fnv1a_64(key), &value});
+    }
+
+    class string_pool final
+    {
+    public:
+        //! \returns the offset of the appended \p str
+        std::uint32_t append(std::string_view str)
+        {
+            if (m_pool.size() + str.size() > std::numeric_limits<std::uint32_t>::max())
+            {
+                throw std::runtime_error("Binary settings string pool exceeds 4 GiB");
+            }
+
+            const auto offset = static_cast<std::uint32_t>(m_pool.size());
+            m_pool.append(str.data(), str.size());
+            return offset;
+        }
+
+        //! \returns the offset of the appended \p count \p numbers, aligned to sizeof(T)
+        template <typename T>
+        std::uint32_t append_numbers(const T* numbers, std::size_t count)
+        {
+            m_pool.resize((m_pool.size() + sizeof(T) - 1) / sizeof(T) * sizeof(T), '\0');
+            return append(std::string_view(reinterpret_cast<const char*>(numbers), count * sizeof(T)));
+        }
+
+        const std::string& str() const noexcept
+        {
+            return m_pool;
+        }
+
+    private:
+        std::string m_pool;
+    };
+
+    binary_settings::entry make_entry(const leaf& leaf, string_pool& pool)
+    {
+        using binary_settings::value_type;
+
+        binary_settings::entry entry{};
+        entry.keyHash = leaf.keyHash;
+        entry.keyOffset = pool.append(leaf.key);
+        entry.keyLength = static_cast<std::uint32_t>(leaf.key.size());
+
+        const auto& value = *leaf.value;
+        if (value.IsArray())
+        {
+            entry.valueLength = value.Size();
+            if (std::all_of(value.Begin(), value.End(), [](const rapidjson::Value& item) { return item.IsInt64(); }))
+            {
+                std::vector<std::int64_t> items;
+                items.reserve(value.Size());
+                std::transform(value.Begin(), value.End(), std::back_inserter(items), [](const rapidjson::Value& item) { return item.GetInt64(); });
+                entry.type = value_type::integer64_array;
+                entry.value = pool.append_numbers(items.data(), items.size());
+            }
+            else
+            {
+                std::vector<double> items;
+                items.reserve(value.Size());
+                std::transform(value.Begin(), value.End(), std::back_inserter(items), [](const rapidjson::Value& item) { return item.GetDouble(); });
+                entry.type = value_type::real_array;
+                entry.value = pool.append_numbers(items.data(), items.size());
+            }
+        }
+        else if (value.IsString())
+        {
+            entry.type = value_type::string;
+            entry.valueLength = value.GetStringLength();
+            entry.value = pool.append(std::string_view(value.GetString(), value.GetStringLength()));
+        }
+        else if (value.IsBool())
+        {
+            entry.type = value_type::boolean;
+            entry.value = value.GetBool() ? 1 : 0;
+        }
+        else if (value.IsInt())
+        {
+            entry.type = value_type::integer;
+            entry.value = static_cast<std::uint64_t>(static_cast<std::int64_t>(value.GetInt()));
+        }
+        else if (value.IsInt64())
+        {
+            entry.type = value_type::integer64;
+            entry.value = static_cast<std::uint64_t>(value.GetInt64());
+        }
+        else if (value.IsNumber())
+        {
+            entry.type = value_type::real;
+            const auto real = value.GetDouble();
+            std::memcpy(&entry.value, &real, sizeof(real));
+        }
+        else
+        {
+            entry.type = value_type::null_value;
+        }
+
+        return entry;
+    }
+}  // namespace
+
+std::string compile_binary_settings(const rapidjson::Value& settings)
+{
+    if (!settings.IsObject())
+    {
+        throw std::runtime_error("Settings root is not an object");
+    }
+
+    std::vector<leaf> leaves;
+    flatten(settings, std::string{}, leaves);
+
+    // stable, i.e. the first of the duplicate keys stays first and survives the unique
+    std::stable_sort(leaves.begin(), leaves.end(), [](const leaf& lhs, const leaf& rhs) {
+        return lhs.keyHash != rhs.keyHash ? lhs.keyHash < rhs.keyHash : lhs.key < rhs.key;
+    });
+    leaves.erase(std::unique(leaves.begin(), leaves.end(), [](const leaf& lhs, const leaf& rhs) { return lhs.key == rhs.key; }),
+                 leaves.end());
+
+    if (leaves.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::runtime_error("Binary settings entry count exceeds the limit");
+    }
+
+    string_pool pool;
+    std::vector<binary_settings::entry> entries;
+    entries.reserve(leaves.size());
+    for (const auto& leaf : leaves)
+    {
+        entries.push_back(make_entry(leaf, pool));
+    }
+
+    binary_settings::header header{};
+    std::memcpy(header.magic, binary_settings::magic, sizeof(header.magic));
+    header.version = binary_settings::version;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    header.stringsOffset = sizeof(header) + entries.size() * sizeof(binary_settings::entry);
+    header.stringsSize = pool.str().size();
+
+    std::string image(static_cast<std::size_t>(header.stringsOffset + header.stringsSize), '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    if (!entries.empty())
+    {
+        std::memcpy(&image[sizeof(header)], entries.data(), entries.size() * sizeof(binary_settings::entry));
+    }
+    std::copy(pool.str().begin(), pool.str().end(), image.begin() + static_cast<std::ptrdiff_t>(header.stringsOffset));
+
+    return image;
+}
+
+void compile_binary_settings(const std::string& jsonFileName, const std::string& binaryFileName)
+{
+    memory_mapped_file file(jsonFileName);
+    rapidjson::Document settings;
+    settings.ParseInsitu(file.data());
+    if (settings.HasParseError())
+    {
+        throw std::runtime_error(rapidjson::GetParseError_En(settings.GetParseError()));
+    }
+
+    const auto image = compile_binary_settings(settings);
+
+    std::ofstream output(binaryFileName, std::ios::binary | std::ios::trunc);
+    if (!output.write(image.data(), static_cast<std::streamsize>(image.size())))
+    {
+        throw std::runtime_error("Cannot write file '" + binaryFileName + "'");
+    }
+}
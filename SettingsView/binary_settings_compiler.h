@@ -0,0 +1,14 @@
+#pragma once
+
+#include <rapidjson/document.h>
+#include <string>
+
+//! Compiles the \p settings object to the binary image (see binary_settings_format.h) read by binary_settings_reader
+//! Of duplicate member names only the first one is compiled, the same one json_settings_reader returns.
+//! The arrays of numbers are compiled as a whole too, i.e. they are readable as numeric_array.
+//! Throws std::runtime_error when \p settings is not an object or the image would exceed the format limits
+std::string compile_binary_settings(const rapidjson::Value& settings);
+
+//! Compiles the JSON file \p jsonFileName and writes the image to \p binaryFileName
+//! Throws std::runtime_error when the JSON cannot be parsed or either file cannot be accessed
+void compile_binary_settings(const std::string& jsonFileName, const std::string& binaryFileName);
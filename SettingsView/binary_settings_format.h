@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+//! Layout of the compiled settings image (see compile_binary_settings and binary_settings_reader)
+//!
+//! | header | entry[header.entryCount] | string pool |
+//!
+//! The entries are sorted by (keyHash, key), i.e. a setting is found by a binary search over the hashes.
+//! The key is settings_path::key, the hash is settings_path::key_hash, i.e. fnv1a_64 of the key.
+//! Every leaf value of the JSON document has its entry, objects and arrays have none, e.g. the array item
+//! is the key "servers/0/name". The keys and the string values are stored in the string pool, not terminated.
+//! An array of numbers has an entry of its own in addition to its items, its items are stored in the pool
+//! contiguously and aligned to 8 bytes, i.e. the reader copies them to numeric_array in bulk.
+//! The numbers are stored in the byte order of the compiling machine.
+namespace binary_settings
+{
+    constexpr char magic[8] = {'S', 'V', 'B', 'I', 'N', '\r', '\n', '\x1a'};
+    constexpr std::uint32_t version = 2;
+
+    enum class value_type : std::uint32_t
+    {
+        null_value,
+        boolean,
+        //! fits to int
+        integer,
+        //! does not fit to int but fits to std::int64_t
+        integer64,
+        real,
+        string,
+        //! all the items are integer or integer64, stored as std::int64_t
+        integer64_array,
+        //! all the items are numbers and some of them real, stored as double
+        real_array
+    };
+
+    struct header final
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        //! the pool follows the entries directly, i.e. it is sizeof(header) + entryCount * sizeof(entry)
+        std::uint64_t stringsOffset;
+        std::uint64_t stringsSize;
+    };
+
+    struct entry final
+    {
+        std::uint64_t keyHash;
+        //! offset to the string pool
+        std::uint32_t keyOffset;
+        std::uint32_t keyLength;
+        value_type type;
+        //! length of the string value, count of the items of the arrays, zero for the other types
+        std::uint32_t valueLength;
+        //! 0 or 1 for boolean, the value for integer and integer64, the bits of double for real
+        //! and offset to the string pool for string and the arrays
+        std::uint64_t value;
+    };
+
+    // the image is mapped as it is, there must be no padding
+    static_assert(sizeof(header) == 32 && std::is_trivially_copyable_v<header>);
+    static_assert(sizeof(entry) == 32 && std::is_trivially_copyable_v<entry>);
+}  // namespace binary_settings
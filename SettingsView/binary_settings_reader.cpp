@@ -0,0 +1,369 @@
+#include "pch.h"
+
+#include "binary_settings_reader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    //! \returns true if the \p length bytes at \p offset are in the pool of the \p poolSize, without overflowing
+    bool in_pool(std::uint64_t offset, std::uint64_t length, std::uint64_t poolSize) noexcept
+    {
+        return offset <= poolSize && length <= poolSize - offset;
+    }
+}  // namespace
+
+binary_settings_reader::binary_settings_reader(const std::string& fileName)
+    : m_file(fileName)
+    , m_entries{nullptr}
+    , m_entryCount{0}
+    , m_strings{nullptr}
+    , m_stringsSize{0}
+    , m_order{entries_order::unknown}
+{
+    const auto invalid = [&fileName](const char* reason) {
+        return std::runtime_error("Invalid binary settings file '" + fileName + "': " + reason);
+    };
+
+    binary_settings::header header{};
+    if (m_file.size() < sizeof(header))
+    {
+        throw invalid("too short");
+    }
+
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, binary_settings::magic, sizeof(header.magic)) != 0)
+    {
+        throw invalid("wrong magic");
+    }
+    if (header.version != binary_settings::version)
+    {
+        throw invalid("unsupported version");
+    }
+    if (header.stringsOffset != sizeof(header) + std::uint64_t{header.entryCount} * sizeof(binary_settings::entry)
+        || header.stringsOffset + header.stringsSize != m_file.size())
+    {
+        throw invalid("wrong size");
+    }
+    // both the mapping and the heap buffer are aligned far better, just to be sure
+    if (reinterpret_cast<std::uintptr_t>(m_file.data()) % alignof(binary_settings::entry) != 0)
+    {
+        throw invalid("misaligned");
+    }
+
+    m_entries = reinterpret_cast<const binary_settings::entry*>(m_file.data() + sizeof(header));
+    m_entryCount = header.entryCount;
+    m_strings = m_file.data() + header.stringsOffset;
+    m_stringsSize = header.stringsSize;
+}
+
+void binary_settings_reader::get(int& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(std::string& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(std::string_view& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(std::int64_t& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(double& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(bool& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(numeric_array<double>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(numeric_array<std::int64_t>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void binary_settings_reader::get(const setting_request* requests, std::size_t count) const
+{
+    settings_errors errors;
+    for (auto request = requests; request != requests + count; ++request)
+    {
+        if (const auto code = read(*request))
+        {
+            errors.add(*request, *code);
+        }
+    }
+
+    errors.throw_if_any();
+}
+
+void binary_settings_reader::for_each(const visitor_t& visitor) const
+{
+    for (auto entry = m_entries; entry != m_entries + m_entryCount; ++entry)
+    {
+        validate(*entry);
+        const auto key = string(entry->keyOffset, entry->keyLength);
+        switch (entry->type)
+        {
+        case binary_settings::value_type::boolean:
+            visitor(key, entry->value != 0);
+            break;
+        case binary_settings::value_type::integer:
+            visitor(key, static_cast<int>(static_cast<std::int64_t>(entry->value)));
+            break;
+        case binary_settings::value_type::integer64:
+            visitor(key, static_cast<std::int64_t>(entry->value));
+            break;
+        case binary_settings::value_type::real:
+            visitor(key, real(entry->value));
+            break;
+        case binary_settings::value_type::string:
+            visitor(key, string(entry->value, entry->valueLength));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void binary_settings_reader::for_each_array(const array_visitor_t& visitor) const
+{
+    for (auto entry = m_entries; entry != m_entries + m_entryCount; ++entry)
+    {
+        if (entry->type == binary_settings::value_type::integer64_array || entry->type == binary_settings::value_type::real_array)
+        {
+            validate(*entry);
+            visitor(string(entry->keyOffset, entry->keyLength));
+        }
+    }
+}
+
+std::optional<setting_errc> binary_settings_reader::find(const settings_path& path, const binary_settings::entry*& entry) const
+{
+    const auto hash = path.key_hash();
+    const auto end = m_entries + m_entryCount;
+    auto it = std::lower_bound(m_entries, end, hash, [](const binary_settings::entry& e, std::uint64_t h) { return e.keyHash < h; });
+    for (; it != end && it->keyHash == hash; ++it)
+    {
+        if (!in_pool(it->keyOffset, it->keyLength, m_stringsSize))
+        {
+            return setting_errc::unreadable;
+        }
+        if (string(it->keyOffset, it->keyLength) == path.key())
+        {
+            entry = it;
+            return invalid_reason(*it) == nullptr ? std::nullopt : std::optional<setting_errc>{setting_errc::unreadable};
+        }
+    }
+
+    // the binary search over unsorted entries may miss an existing key
+    return sorted() ? setting_errc::not_found : setting_errc::unreadable;
+}
+
+const char* binary_settings_reader::invalid_reason(const binary_settings::entry& entry) const noexcept
+{
+    if (!in_pool(entry.keyOffset, entry.keyLength, m_stringsSize)
+        || (entry.type == binary_settings::value_type::string && !in_pool(entry.value, entry.valueLength, m_stringsSize)))
+    {
+        return "string out of range";
+    }
+    if ((entry.type == binary_settings::value_type::integer64_array || entry.type == binary_settings::value_type::real_array)
+        && (entry.value % sizeof(std::uint64_t) != 0
+            || !in_pool(entry.value, std::uint64_t{entry.valueLength} * sizeof(std::uint64_t), m_stringsSize)))
+    {
+        return "array out of range";
+    }
+
+    return nullptr;
+}
+
+void binary_settings_reader::validate(const binary_settings::entry& entry) const
+{
+    if (const auto reason = invalid_reason(entry))
+    {
+        throw std::runtime_error("Invalid binary settings entry " + std::to_string(&entry - m_entries) + ": " + reason);
+    }
+}
+
+bool binary_settings_reader::sorted() const noexcept
+{
+    auto order = m_order.load(std::memory_order_relaxed);
+    if (order == entries_order::unknown)
+    {
+        const auto isSorted = std::is_sorted(m_entries, m_entries + m_entryCount,
+                                             [](const binary_settings::entry& a, const binary_settings::entry& b) { return a.keyHash < b.keyHash; });
+        order = isSorted ? entries_order::sorted : entries_order::unsorted;
+        m_order.store(order, std::memory_order_relaxed);
+    }
+
+    return order == entries_order::sorted;
+}
+
+std::string_view binary_settings_reader::string(std::uint64_t offset, std::uint32_t length) const noexcept
+{
+    return std::string_view(m_strings + offset, length);
+}
+
+double binary_settings_reader::real(std::uint64_t bits) noexcept
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+template <typename T>
+const T* binary_settings_reader::numbers(std::uint64_t offset) const noexcept
+{
+    // the offset is aligned, checked by ::invalid_reason before the entry is converted
+    return reinterpret_cast<const T*>(m_strings + offset);
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, int& value) const
+{
+    if (entry.type != binary_settings::value_type::integer)
+    {
+        return false;
+    }
+
+    value = static_cast<int>(static_cast<std::int64_t>(entry.value));
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, std::string& value) const
+{
+    if (entry.type != binary_settings::value_type::string)
+    {
+        return false;
+    }
+
+    value = std::string(string(entry.value, entry.valueLength));
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, std::string_view& value) const
+{
+    if (entry.type != binary_settings::value_type::string)
+    {
+        return false;
+    }
+
+    value = string(entry.value, entry.valueLength);
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, std::int64_t& value) const
+{
+    if (entry.type != binary_settings::value_type::integer && entry.type != binary_settings::value_type::integer64)
+    {
+        return false;
+    }
+
+    value = static_cast<std::int64_t>(entry.value);
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, double& value) const
+{
+    switch (entry.type)
+    {
+    case binary_settings::value_type::integer:
+    case binary_settings::value_type::integer64:
+        value = static_cast<double>(static_cast<std::int64_t>(entry.value));
+        return true;
+    case binary_settings::value_type::real:
+        value = real(entry.value);
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, bool& value) const
+{
+    if (entry.type != binary_settings::value_type::boolean)
+    {
+        return false;
+    }
+
+    value = entry.value != 0;
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, numeric_array<double>& value) const
+{
+    if (entry.type != binary_settings::value_type::integer64_array && entry.type != binary_settings::value_type::real_array)
+    {
+        return false;
+    }
+
+    numeric_array<double> result(entry.valueLength);
+    if (entry.type == binary_settings::value_type::real_array)
+    {
+        convert_numbers(numbers<double>(entry.value), entry.valueLength, result.data());
+    }
+    else
+    {
+        convert_numbers(numbers<std::int64_t>(entry.value), entry.valueLength, result.data());
+    }
+
+    value = std::move(result);
+    return true;
+}
+
+bool binary_settings_reader::convert(const binary_settings::entry& entry, numeric_array<std::int64_t>& value) const
+{
+    if (entry.type != binary_settings::value_type::integer64_array)
+    {
+        return false;
+    }
+
+    numeric_array<std::int64_t> result(entry.valueLength);
+    convert_numbers(numbers<std::int64_t>(entry.value), entry.valueLength, result.data());
+
+    value = std::move(result);
+    return true;
+}
+
+std::optional<setting_errc> binary_settings_reader::read(const setting_request& request) const
+{
+    const binary_settings::entry* entry = nullptr;
+    if (const auto code = find(*request.path, entry))
+    {
+        return code;
+    }
+
+    const auto converted = std::visit([this, entry](auto destination) { return convert(*entry, *destination); }, request.destination);
+    if (!converted)
+    {
+        return setting_errc::type_mismatch;
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "binary_settings_format.h"
+#include "memory_mapped_file.h"
+#include "settings_reader.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+//! Reads the settings image compiled by compile_binary_settings
+//! The file is mapped to memory and used as it is, the construction validates the header and the section bounds
+//! only, i.e. it takes the same time for any count of settings. An entry is validated when it is accessed: the getters
+//! report an entry pointing out of the string pool as setting_errc::unreadable, ::for_each throws.
+//! A lookup is a binary search over the key hashes, the std::string_view getter points directly to the mapped file.
+//! The arrays are copied from the file in bulk (see convert_numbers).
+class binary_settings_reader final : public settings_reader
+{
+public:
+    //! Throws std::runtime_error when the file cannot be mapped or its header is not valid
+    explicit binary_settings_reader(const std::string& fileName);
+
+    void get(int& value, const settings_path& path) const override;
+
+    void get(std::string& value, const settings_path& path) const override;
+    void get(std::string_view& value, const settings_path& path) const override;
+
+    void get(std::int64_t& value, const settings_path& path) const override;
+    void get(double& value, const settings_path& path) const override;
+    void get(bool& value, const settings_path& path) const override;
+    void get(numeric_array<double>& value, const settings_path& path) const override;
+    void get(numeric_array<std::int64_t>& value, const settings_path& path) const override;
+
+    void get(const setting_request* requests, std::size_t count) const override;
+
+    //! The nulls and the arrays as a whole are skipped, in the order of the image (i.e. of the key hashes)
+    //! Throws std::runtime_error when an entry is not valid
+    void for_each(const visitor_t& visitor) const override;
+    //! The arrays of numbers only, the other arrays have no entry of their own (see binary_settings::entry)
+    void for_each_array(const array_visitor_t& visitor) const override;
+
+private:
+    //! Reads the single \p request without throwing, the batch ::get and the default settings_reader::try_get call it
+    std::optional<setting_errc> read(const setting_request& request) const override;
+
+    //! Finds the \p entry of the \p path
+    //! \returns setting_errc::not_found, setting_errc::unreadable if the image is corrupt or std::nullopt when found
+    std::optional<setting_errc> find(const settings_path& path, const binary_settings::entry*& entry) const;
+
+    //! \returns the reason why the \p entry is not valid or nullptr if it is valid
+    const char* invalid_reason(const binary_settings::entry& entry) const noexcept;
+    //! Checks the \p entry, throws std::runtime_error if it is not valid
+    void validate(const binary_settings::entry& entry) const;
+    //! \returns true if the entries are sorted by the key hashes, checked by the first call
+    //! An unsorted image is detected on a miss only, the binary search compares the keys of the entries it finds.
+    bool sorted() const noexcept;
+
+    std::string_view string(std::uint64_t offset, std::uint32_t length) const noexcept;
+    static double real(std::uint64_t bits) noexcept;
+    //! \returns the items of the array stored at \p offset of the pool
+    template <typename T>
+    const T* numbers(std::uint64_t offset) const noexcept;
+
+    //! Converts the \p entry to \p value
+    //! \returns false if the \p entry is not of the requested type
+    bool convert(const binary_settings::entry& entry, int& value) const;
+    bool convert(const binary_settings::entry& entry, std::string& value) const;
+    bool convert(const binary_settings::entry& entry, std::string_view& value) const;
+    bool convert(const binary_settings::entry& entry, std::int64_t& value) const;
+    bool convert(const binary_settings::entry& entry, double& value) const;
+    bool convert(const binary_settings::entry& entry, bool& value) const;
+    bool convert(const binary_settings::entry& entry, numeric_array<double>& value) const;
+    bool convert(const binary_settings::entry& entry, numeric_array<std::int64_t>& value) const;
+
+    memory_mapped_file m_file;
+    const binary_settings::entry* m_entries;
+    std::size_t m_entryCount;
+    const char* m_strings;
+    std::uint64_t m_stringsSize;
+
+    enum class entries_order
+    {
+        unknown,
+        sorted,
+        unsorted
+    };
+
+    //! Set by ::sorted, racing threads compute the same value
+    mutable std::atomic<entries_order> m_order;
+};
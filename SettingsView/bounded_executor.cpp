@@ -0,0 +1,117 @@
+#include "pch.h"
+
+#include "bounded_executor.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+bounded_executor::bounded_executor(std::size_t threadsCount, std::size_t capacity, overflow_policy policy)
+    : m_capacity{capacity}
+    , m_policy{policy}
+    , m_running{0}
+    , m_discarded{0}
+    , m_stopping{false}
+{
+    if (threadsCount == 0 || capacity == 0)
+    {
+        throw std::invalid_argument("threadsCount and capacity must not be zero");
+    }
+
+    m_workers.reserve(threadsCount);
+    for (std::size_t i = 0; i < threadsCount; ++i)
+    {
+        m_workers.emplace_back([this]() { run(); });
+    }
+}
+
+bounded_executor::~bounded_executor()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        m_stopping = true;
+    }
+    m_posted.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void bounded_executor::post(task_t&& task, const void* coalesceKey)
+{
+    {
+        std::unique_lock<std::mutex> lock{m_mtx};
+
+        if (m_policy == overflow_policy::coalesce && coalesceKey != nullptr)
+        {
+            const auto pendingIt = std::find_if(m_pending.begin(), m_pending.end(), [coalesceKey](const pending_task& pending) {
+                return pending.coalesceKey == coalesceKey;
+            });
+            if (pendingIt != m_pending.end())
+            {
+                pendingIt->task = std::move(task);
+                ++m_discarded;
+                return;
+            }
+        }
+
+        if (m_pending.size() == m_capacity && m_policy == overflow_policy::drop_oldest)
+        {
+            m_pending.pop_front();
+            ++m_discarded;
+        }
+
+        m_taken.wait(lock, [this]() { return m_pending.size() < m_capacity; });
+        m_pending.push_back(pending_task{std::move(task), coalesceKey});
+    }
+    m_posted.notify_one();
+}
+
+void bounded_executor::wait_idle()
+{
+    std::unique_lock<std::mutex> lock{m_mtx};
+    m_taken.wait(lock, [this]() { return m_pending.empty() && m_running == 0; });
+}
+
+std::size_t bounded_executor::discarded() const
+{
+    std::lock_guard<std::mutex> lock{m_mtx};
+    return m_discarded;
+}
+
+void bounded_executor::run()
+{
+    std::unique_lock<std::mutex> lock{m_mtx};
+    while (true)
+    {
+        m_posted.wait(lock, [this]() { return !m_pending.empty() || m_stopping; });
+        if (m_pending.empty())
+        {
+            // stopping and nothing left to run
+            return;
+        }
+
+        {
+            // the task (and whatever it captures) is released before the lock is taken again
+            auto task = std::move(m_pending.front().task);
+            m_pending.pop_front();
+            ++m_running;
+            lock.unlock();
+            m_taken.notify_all();
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        lock.lock();
+        --m_running;
+        // wait_idle waits for the running tasks as well
+        m_taken.notify_all();
+    }
+}
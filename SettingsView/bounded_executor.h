@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Runs the posted tasks on a fixed pool of worker threads
+//! The queue of the pending tasks is bounded, the overflow_policy decides what happens when it is full.
+//! The tasks are started in the posting order, with more than one thread they may run concurrently.
+class bounded_executor final
+{
+public:
+    using task_t = std::function<void()>;
+
+    enum class overflow_policy
+    {
+        //! ::post waits until a worker takes a pending task
+        block,
+        //! the oldest pending task is discarded to make room for the posted one
+        drop_oldest,
+        //! a pending task posted with the same key is replaced by the posted one (at its position in the queue)
+        //! the key is compared even when the queue is not full, ::post waits if it is full and there is no such task
+        coalesce
+    };
+
+    //! Throws std::invalid_argument when \p threadsCount or \p capacity is zero
+    bounded_executor(std::size_t threadsCount, std::size_t capacity, overflow_policy policy);
+    // the workers refer to the instance
+    bounded_executor(const bounded_executor&) = delete;
+    bounded_executor& operator=(const bounded_executor&) = delete;
+    //! Runs the pending tasks and joins the workers
+    ~bounded_executor();
+
+    //! Thread safe
+    //! The \p coalesceKey identifies the tasks replacing each other with the overflow_policy::coalesce, nullptr never coalesces
+    //! The exceptions thrown by the task are caught and ignored, there is nobody to report them to.
+    //! Note that posting from a task with overflow_policy::block can deadlock when all the workers do the same.
+    void post(task_t&& task, const void* coalesceKey = nullptr);
+
+    //! Thread safe, waits until there is no pending nor running task
+    void wait_idle();
+
+    //! Thread safe, count of the tasks discarded by overflow_policy::drop_oldest or replaced by overflow_policy::coalesce
+    std::size_t discarded() const;
+
+private:
+    struct pending_task final
+    {
+        task_t task;
+        const void* coalesceKey;
+    };
+
+    void run();
+
+    const std::size_t m_capacity;
+    const overflow_policy m_policy;
+
+    mutable std::mutex m_mtx;
+    //! signalled when a task is posted or the executor stops
+    std::condition_variable m_posted;
+    //! signalled when a task is taken from the queue or finished
+    std::condition_variable m_taken;
+    std::deque<pending_task> m_pending;
+    std::size_t m_running;
+    std::size_t m_discarded;
+    bool m_stopping;
+
+    std::vector<std::thread> m_workers;
+};
@@ -1,13 +1,14 @@
 #pragma once
 
-#include "monitor.h"
+#include "bounded_executor.h"
+#include "slot_map.h"
 
 #include <cassert>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <tuple>
 #include <type_traits>
-#include <unordered_map>
 
 // Enables to use the observer pattern with the callback_container class
 // note: More effective than usage of std::bind
@@ -53,13 +54,25 @@ template <typename>
 class callback_token;
 
 // type T the type of callback method (lambda, functor, std::function etc.)
-// type Mtx the mutex type to be used for const method synchronization
-//      exclusive mutex (i.e. std::mutex) - all calls are fully synchronized, i.e. calling const methods from fired callbacks results in a deadlock
-//      rw-mutex (i.e. std::shared_mutex) - enables to call operator() from multiple threads in the same time (the operator requires reader access)
-//                          still calling const methods from fired callbacks results in a deadlock (write access is required)
-//      reentrant mutex (i.e. std::recursive_mutex) - enables calling const methods from fired callbacks
-//                             calling unregister from the callback will grant hat the next invocation of operator() will not trigger the unregistered callback
-//                             the callback can still be triggered in the current operator() execution
+// type Mtx the mutex type to be used for register/unregister synchronization
+//      operator() does not lock at all, it iterates the slots of the callbacks in place (see slot_map),
+//      register/unregister are O(1), therefore with any mutex type (i.e. std::mutex, std::shared_mutex, std::recursive_mutex)
+//      - operator() can be called from multiple threads in the same time
+//      - const methods can be called from fired callbacks
+//      - when unregister (or the token destructor) returns, the callback is not running on any other thread and will not be triggered again,
+//        i.e. the observer can be destroyed right after its token; unregister waits for the calls in progress (without holding Mtx)
+//      - calling unregister from the callback will grant that the next invocation of operator() will not trigger the unregistered callback,
+//        the current execution of the callback finishes (the callback is released when it returns)
+//        note: two callbacks unregistering each other while both are running on different threads deadlock
+//      - callback registered from a callback will be fired with the next invocation of operator()
+//
+// Created with an executor the container dispatches asynchronously: operator() copies the arguments and posts
+// a single task firing all the callbacks to the executor, i.e. a slow callback does not stall the caller.
+// The container does not own the executor (the pending task keeps the container alive, the container must not keep
+// the executor alive on its own worker), the owner keeps it alive. Once the executor is gone the container dispatches synchronously.
+// The task posted by the container is keyed by the container for bounded_executor::overflow_policy::coalesce,
+// i.e. the pending dispatch is replaced by the newest one. Arguments that cannot be copied and callbacks that cannot
+// be called with the copies of the arguments (e.g. taking non-const references) are always dispatched synchronously.
 template <typename T, typename Mtx = std::mutex>
 class callback_container final : public std::enable_shared_from_this<callback_container<T, Mtx>>
 {
@@ -72,7 +85,7 @@ public:
     friend token_t;
 
 private:
-    callback_container() = default;
+    explicit callback_container(std::shared_ptr<bounded_executor> executor);
     // copy does not make sense
     callback_container(const callback_container&) = delete;
 
@@ -80,7 +93,8 @@ public:
     callback_container(callback_container&&) = default;
     callback_container& operator=(callback_container&&) = default;
 
-    static std::shared_ptr<callback_container> create_callback_container();
+    //! The \p executor enables the asynchronous dispatch, it is not owned by the container, see the class description
+    static std::shared_ptr<callback_container> create_callback_container(std::shared_ptr<bounded_executor> executor = nullptr);
 
     // thread safe
     // the new registered callback will be fired with the next call to operator()
@@ -93,14 +107,18 @@ public:
     void operator()(Args&&... args) const;
 
 private:
-    using callback_container_t = std::unordered_map<std::size_t, callback_t>;
-
     // thread safe
     // callback will be unregistered and the next call to operator() will not trigger it
+    // returns when no other thread runs the callback
+    // a stale key (its callback was unregistered already) does nothing, even if its slot holds a newer callback
     // see Mtx template argument description
-    void unregister_callback(std::size_t idx) const;
+    void unregister_callback(key_t key) const;
 
-    monitor<callback_container_t, mutex_t> m_callbacks;
+    // serializes the writers (register/unregister)
+    mutable mutex_t m_writerMtx;
+    mutable slot_map<callback_t> m_callbacks;
+    // empty for the synchronous dispatch
+    std::weak_ptr<bounded_executor> m_executor;
 };
 
 // T type of callback container that will use this class as token
@@ -111,9 +129,9 @@ class callback_token final
 
 private:
     using instance_t = std::weak_ptr<const T>;
-    using key_t = std::size_t;
+    using key_t = slot_handle;
 
-    callback_token(const instance_t& instance, key_t idx);
+    callback_token(const instance_t& instance, key_t key);
     // If you need to share-own, move the instance to a std::shared_ptr
     callback_token(const callback_token&) = delete;
 
@@ -128,7 +146,7 @@ public:
 
 private:
     instance_t m_instance;
-    key_t m_idx;
+    key_t m_key;
 };
 
 template <typename I, typename T, typename... Args>
@@ -149,56 +167,64 @@ void observer_adapter<I, T, Args...>::operator()(Args... args) const
 }
 
 template <typename T, typename Mtx>
-std::shared_ptr<callback_container<T, Mtx>> callback_container<T, Mtx>::create_callback_container()
+callback_container<T, Mtx>::callback_container(std::shared_ptr<bounded_executor> executor)
+    : m_executor{std::move(executor)}
 {
-    return std::shared_ptr<callback_container>(new callback_container);
+}
+
+template <typename T, typename Mtx>
+std::shared_ptr<callback_container<T, Mtx>> callback_container<T, Mtx>::create_callback_container(std::shared_ptr<bounded_executor> executor)
+{
+    return std::shared_ptr<callback_container>(new callback_container(std::move(executor)));
 }
 
 template <typename T, typename Mtx>
 typename callback_container<T, Mtx>::token_t callback_container<T, Mtx>::register_callback(callback_t&& callback) const
 {
-    return m_callbacks([this, callback{std::move(callback)}](callback_container_t& container) mutable {
-        // TODO suboptimal
-        key_t key = container.size();
-        while (container.find(key) != container.end()) {
-            key++;
-        }
-        container.emplace(key, std::move(callback));
-    
-        return token_t(this->shared_from_this(), key);
-    });
+    auto value = std::make_unique<const callback_t>(std::move(callback));
+
+    std::lock_guard<mutex_t> lock{m_writerMtx};
+    return token_t(this->shared_from_this(), m_callbacks.insert(std::move(value)));
 }
 
 template <typename T, typename Mtx>
 template <typename... Args, typename>
 void callback_container<T, Mtx>::operator()(Args&&... args) const
 {
-    m_callbacks([&args...](const callback_container_t& container) {
-        // TODO is necessary only if the mutex is reentrant, i.e. std::recursive_mutex
-        // copy will ensure, that the container can be safely modified from the callback
-        // without invalidating the iterators used in the following for loop
-        const auto containerCopy = container;
-
-        for (const auto& callback : containerCopy)
+    if constexpr ((std::is_constructible_v<std::decay_t<Args>, Args&&> && ...) && std::is_invocable_v<const callback_t&, const std::decay_t<Args>&...>)
+    {
+        if (const auto executor = m_executor.lock())
         {
-            std::invoke(callback.second, std::forward<Args>(args)...);
+            // the container is kept alive until the task fires the callbacks
+            auto arguments = std::make_shared<const std::tuple<std::decay_t<Args>...>>(std::forward<Args>(args)...);
+            executor->post(
+                [self = this->shared_from_this(), arguments]() {
+                    self->m_callbacks.for_each([&arguments](const callback_t& callback) { std::apply(callback, *arguments); });
+                },
+                this);
+            return;
         }
-    });
+    }
+
+    // the slots are never moved, they can be modified from the callbacks without invalidating the iteration
+    m_callbacks.for_each([&args...](const callback_t& callback) { std::invoke(callback, std::forward<Args>(args)...); });
 }
 
 template <typename T, typename Mtx>
-void callback_container<T, Mtx>::unregister_callback(std::size_t idx) const
+void callback_container<T, Mtx>::unregister_callback(key_t key) const
 {
-    return m_callbacks([=](callback_container_t& container) {
-        const auto removedCount = container.erase(idx);
-        assert(removedCount == 1);
-    });
+    typename slot_map<callback_t>::erased_element erased;
+    {
+        std::lock_guard<mutex_t> lock{m_writerMtx};
+        erased = m_callbacks.erase(key);
+    }
+    // waits for the calls in progress on the other threads, the callbacks may take the lock meanwhile
 }
 
 template <typename T>
-callback_token<T>::callback_token(const instance_t& instance, key_t idx)
+callback_token<T>::callback_token(const instance_t& instance, key_t key)
     : m_instance(instance)
-    , m_idx{idx}
+    , m_key{key}
 {
 }
 
@@ -214,7 +240,7 @@ void callback_token<T>::unregister()
     auto instanceLocked = m_instance.lock();
     if (instanceLocked)
     {
-        instanceLocked->unregister_callback(m_idx);
+        instanceLocked->unregister_callback(m_key);
     }
     m_instance.reset();
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "pch.h"
+
+#include "json_settings_loader.h"
+
+#include "layered_settings_reader.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    //! Counts the finished tasks of a single ::load call, the executor may be running the tasks of the other calls
+    class completion final
+    {
+    public:
+        void finished()
+        {
+            // notified under the lock, the waiting ::load may return and destroy this instance as soon as it is released
+            std::lock_guard<std::mutex> lock{m_mtx};
+            ++m_finished;
+            m_cv.notify_one();
+        }
+
+        void wait(std::size_t count)
+        {
+            std::unique_lock<std::mutex> lock{m_mtx};
+            m_cv.wait(lock, [this, count]() { return m_finished == count; });
+        }
+
+    private:
+        std::mutex m_mtx;
+        std::condition_variable m_cv;
+        std::size_t m_finished{0};
+    };
+}  // namespace
+
+json_settings_loader::json_settings_loader(std::size_t threadsCount)
+    // a full queue blocks the posting thread, there is no point in queueing more files than the workers can take
+    : m_executor(threadsCount, threadsCount, bounded_executor::overflow_policy::block)
+{
+}
+
+std::vector<std::unique_ptr<json_settings_reader>> json_settings_loader::load(const std::vector<std::string>& fileNames) const
+{
+    std::vector<std::unique_ptr<json_settings_reader>> readers(fileNames.size());
+    // each task writes its own slot, i.e. no locking is needed
+    std::vector<std::string> errors(fileNames.size());
+    completion done;
+
+    std::size_t posted = 0;
+    try
+    {
+        for (; posted < fileNames.size(); ++posted)
+        {
+            m_executor.post([&fileNames, &readers, &errors, &done, i = posted]() {
+                try
+                {
+                    readers[i] = std::make_unique<json_settings_reader>(fileNames[i]);
+                }
+                catch (const std::exception& ex)
+                {
+                    errors[i] = ex.what();
+                }
+                catch (...)
+                {
+                    errors[i] = "unknown error";
+                }
+                done.finished();
+            });
+        }
+    }
+    catch (...)
+    {
+        // the posted tasks refer to the locals
+        done.wait(posted);
+        throw;
+    }
+    done.wait(posted);
+
+    settings_errors loadErrors;
+    for (std::size_t i = 0; i < fileNames.size(); ++i)
+    {
+        if (!readers[i])
+        {
+            loadErrors.add(("Cannot load settings file '" + fileNames[i] + "': " + errors[i]).c_str());
+        }
+    }
+    loadErrors.throw_if_any();
+
+    return readers;
+}
+
+std::unique_ptr<settings_reader> json_settings_loader::load_layered(const std::vector<std::string>& fileNames) const
+{
+    auto readers = load(fileNames);
+
+    std::vector<std::unique_ptr<const settings_reader>> layers;
+    layers.reserve(readers.size());
+    for (auto& reader : readers)
+    {
+        layers.push_back(std::move(reader));
+    }
+
+    return std::make_unique<layered_settings_reader>(std::move(layers));
+}
+
+std::size_t json_settings_loader::default_threads_count() noexcept
+{
+    const auto threadsCount = std::thread::hardware_concurrency();
+    return threadsCount == 0 ? 1 : threadsCount;
+}
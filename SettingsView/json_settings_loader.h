@@ -0,0 +1,42 @@
+#pragma once
+
+#include "bounded_executor.h"
+#include "json_settings_reader.h"
+#include "settings_reader.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+//! Parses several JSON settings files concurrently, e.g. the base file and its overrides at startup
+//! Each file is parsed into its own json_settings_reader by a worker of the loader's fixed thread pool,
+//! i.e. the loading takes about as long as the largest file rather than the sum of all of them.
+//! The merged settings are passed to settings_provider (or its ::reload) as any other reader:
+//!
+//!     const json_settings_loader loader;
+//!     settings_provider provider(loader.load_layered({"defaults.json", "site.json", "host.json"}));
+class json_settings_loader final
+{
+public:
+    //! Throws std::invalid_argument when \p threadsCount is zero
+    explicit json_settings_loader(std::size_t threadsCount = default_threads_count());
+
+    //! Thread safe, the calls share the pool
+    //! \returns the readers in the order of the \p fileNames
+    //! Throws a single std::runtime_error describing every file that cannot be loaded (one per line),
+    //! all the files are attempted even when some of them fail
+    std::vector<std::unique_ptr<json_settings_reader>> load(const std::vector<std::string>& fileNames) const;
+
+    //! Thread safe, the \p fileNames are the layers of layered_settings_reader, i.e. a later file overrides the earlier ones
+    //! An array of a later file replaces the array of the earlier ones as a whole, it stays readable as numeric_array
+    //! Throws as ::load
+    std::unique_ptr<settings_reader> load_layered(const std::vector<std::string>& fileNames) const;
+
+    //! \returns the count of the hardware threads, at least one
+    static std::size_t default_threads_count() noexcept;
+
+private:
+    //! mutable as posting does not change the observable state of the loader
+    mutable bounded_executor m_executor;
+};
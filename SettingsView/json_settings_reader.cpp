@@ -4,56 +4,384 @@
 
 #include <rapidjson/error/en.h>
 
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
 json_settings_reader::json_settings_reader(rapidjson::Document&& settings)
     : m_settings(std::move(settings))
+{
+    initialize();
+}
+
+json_settings_reader::json_settings_reader(const std::string& fileName)
+    : json_settings_reader(std::make_unique<memory_mapped_file>(fileName))
+{
+}
+
+json_settings_reader::json_settings_reader(std::unique_ptr<memory_mapped_file>&& file)
+    : m_file(std::move(file))
+{
+    if (!m_file)
+    {
+        throw std::invalid_argument("file must not be null");
+    }
+
+    // the mapped file is always terminated by '\0' as the in-situ parsing requires
+    m_settings.ParseInsitu(m_file->data());
+    initialize();
+}
+
+void json_settings_reader::initialize()
 {
     if (m_settings.HasParseError())
     {
         const auto errorMsg = rapidjson::GetParseError_En(m_settings.GetParseError());
         throw std::runtime_error(errorMsg);
     }
+
+    if (!m_settings.IsObject())
+    {
+        throw std::runtime_error("Settings root is not an object");
+    }
+
+    // The document is not modified after construction, the member names and values stay where they are
+    index(m_settings);
+}
+
+void json_settings_reader::get(int& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(std::string& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(std::string_view& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(std::int64_t& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(double& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
 }
 
-void json_settings_reader::get(int& value, const std::string& path)
+void json_settings_reader::get(bool& value, const settings_path& path) const
 {
-    get(value, path.c_str());
+    const setting_request request{&path, &value};
+    get(&request, 1);
 }
 
-void json_settings_reader::get(int& value, const char* path)
+void json_settings_reader::get(numeric_array<double>& value, const settings_path& path) const
 {
-    const auto valueIt = m_settings.FindMember(path);
-    if (valueIt == m_settings.MemberEnd())
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(numeric_array<std::int64_t>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void json_settings_reader::get(const setting_request* requests, std::size_t count) const
+{
+    settings_errors errors;
+
+    for (auto request = requests; request != requests + count; ++request)
     {
-        throw std::runtime_error(std::string("Member '") + path + "' not found");
+        if (const auto code = read(*request))
+        {
+            errors.add(*request, *code);
+        }
     }
 
-    const auto& jsonValue = valueIt->value;
-    if (!jsonValue.IsInt())
+    errors.throw_if_any();
+}
+
+void json_settings_reader::for_each(const visitor_t& visitor) const
+{
+    std::string key;
+    for_each(m_settings, key, visitor);
+}
+
+void json_settings_reader::for_each_array(const array_visitor_t& visitor) const
+{
+    std::string key;
+    for_each_array(m_settings, key, visitor);
+}
+
+bool json_settings_reader::member_key::operator==(const member_key& other) const noexcept
+{
+    return parent == other.parent && nameHash == other.nameHash && name == other.name;
+}
+
+std::size_t json_settings_reader::member_key_hash::operator()(const member_key& key) const noexcept
+{
+    return std::hash<const void*>{}(key.parent) * 31 + key.nameHash;
+}
+
+void json_settings_reader::index(const rapidjson::Value& value)
+{
+    if (value.IsArray())
     {
-        throw std::runtime_error(std::string("Member '") + path + "' is not of type int");
+        for (auto itemIt = value.Begin(); itemIt != value.End(); ++itemIt)
+        {
+            index(*itemIt);
+        }
     }
 
-    value = jsonValue.GetInt();
+    if (!value.IsObject())
+    {
+        return;
+    }
+
+    for (auto memberIt = value.MemberBegin(); memberIt != value.MemberEnd(); ++memberIt)
+    {
+        const std::string_view name(memberIt->name.GetString(), memberIt->name.GetStringLength());
+        // emplace keeps the first member of duplicate names, the same one FindMember would return
+        m_members.emplace(member_key{&value, name, std::hash<std::string_view>{}(name)}, &memberIt->value);
+        index(memberIt->value);
+    }
+}
+
+void json_settings_reader::for_each(const rapidjson::Value& value, std::string& key, const visitor_t& visitor)
+{
+    // the key is extended by the child token and restored afterwards, i.e. a single buffer serves the whole walk
+    const auto visitChild = [&key, &visitor](const rapidjson::Value& child, const std::string& escapedName) {
+        const auto parentLength = key.size();
+        if (!key.empty())
+        {
+            key += settings_path::separator;
+        }
+        key += escapedName;
+        for_each(child, key, visitor);
+        key.resize(parentLength);
+    };
+
+    if (value.IsObject())
+    {
+        for (auto memberIt = value.MemberBegin(); memberIt != value.MemberEnd(); ++memberIt)
+        {
+            const std::string_view name(memberIt->name.GetString(), memberIt->name.GetStringLength());
+            visitChild(memberIt->value, settings_path::escape(name));
+        }
+    }
+    else if (value.IsArray())
+    {
+        for (rapidjson::SizeType i = 0; i < value.Size(); ++i)
+        {
+            visitChild(value[i], std::to_string(i));
+        }
+    }
+    else if (value.IsInt())
+    {
+        visitor(key, value.GetInt());
+    }
+    else if (value.IsInt64())
+    {
+        visitor(key, value.GetInt64());
+    }
+    else if (value.IsNumber())
+    {
+        visitor(key, value.GetDouble());
+    }
+    else if (value.IsBool())
+    {
+        visitor(key, value.GetBool());
+    }
+    else if (value.IsString())
+    {
+        visitor(key, std::string_view(value.GetString(), value.GetStringLength()));
+    }
+}
+
+void json_settings_reader::for_each_array(const rapidjson::Value& value, std::string& key, const array_visitor_t& visitor)
+{
+    // the same key building as by ::for_each
+    const auto visitChild = [&key, &visitor](const rapidjson::Value& child, const std::string& escapedName) {
+        const auto parentLength = key.size();
+        if (!key.empty())
+        {
+            key += settings_path::separator;
+        }
+        key += escapedName;
+        for_each_array(child, key, visitor);
+        key.resize(parentLength);
+    };
+
+    if (value.IsObject())
+    {
+        for (auto memberIt = value.MemberBegin(); memberIt != value.MemberEnd(); ++memberIt)
+        {
+            const std::string_view name(memberIt->name.GetString(), memberIt->name.GetStringLength());
+            visitChild(memberIt->value, settings_path::escape(name));
+        }
+    }
+    else if (value.IsArray())
+    {
+        visitor(key);
+        for (rapidjson::SizeType i = 0; i < value.Size(); ++i)
+        {
+            visitChild(value[i], std::to_string(i));
+        }
+    }
 }
 
-void json_settings_reader::get(std::string& value, const std::string& path)
+const rapidjson::Value* json_settings_reader::find(const settings_path& path) const
 {
-    get(value, path.c_str());
+    const rapidjson::Value* value = &m_settings;
+    for (const auto& token : path.tokens())
+    {
+        if (value->IsArray())
+        {
+            if (token.index >= value->Size())
+            {
+                return nullptr;
+            }
+            value = &(*value)[static_cast<rapidjson::SizeType>(token.index)];
+            continue;
+        }
+
+        const auto memberIt = m_members.find(member_key{value, token.name, token.hash});
+        if (memberIt == m_members.end())
+        {
+            return nullptr;
+        }
+        value = memberIt->second;
+    }
+
+    return value;
 }
 
-void json_settings_reader::get(std::string& value, const char* path)
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, int& value)
 {
-    const auto valueIt = m_settings.FindMember(path);
-    if (valueIt == m_settings.MemberEnd())
+    if (!jsonValue.IsInt())
     {
-        throw std::runtime_error(std::string("Member '") + path + "' not found");
+        return false;
     }
 
-    const auto& jsonValue = valueIt->value;
+    value = jsonValue.GetInt();
+    return true;
+}
+
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, std::string& value)
+{
     if (!jsonValue.IsString())
     {
-        throw std::runtime_error(std::string("Member '") + path + "' is not of type string");
+        return false;
     }
 
     value = std::string(jsonValue.GetString(), jsonValue.GetStringLength());
+    return true;
+}
+
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, std::string_view& value)
+{
+    if (!jsonValue.IsString())
+    {
+        return false;
+    }
+
+    value = std::string_view(jsonValue.GetString(), jsonValue.GetStringLength());
+    return true;
+}
+
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, std::int64_t& value)
+{
+    if (!jsonValue.IsInt64())
+    {
+        return false;
+    }
+
+    value = jsonValue.GetInt64();
+    return true;
+}
+
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, double& value)
+{
+    if (!jsonValue.IsNumber())
+    {
+        return false;
+    }
+
+    value = jsonValue.GetDouble();
+    return true;
+}
+
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, bool& value)
+{
+    if (!jsonValue.IsBool())
+    {
+        return false;
+    }
+
+    value = jsonValue.GetBool();
+    return true;
+}
+
+template <typename T>
+bool json_settings_reader::convert(const rapidjson::Value& jsonValue, numeric_array<T>& value)
+{
+    if (!jsonValue.IsArray())
+    {
+        return false;
+    }
+
+    for (auto itemIt = jsonValue.Begin(); itemIt != jsonValue.End(); ++itemIt)
+    {
+        if (!(std::is_same_v<T, double> ? itemIt->IsNumber() : itemIt->IsInt64()))
+        {
+            return false;
+        }
+    }
+
+    numeric_array<T> result(jsonValue.Size());
+    auto destination = result.data();
+    for (auto itemIt = jsonValue.Begin(); itemIt != jsonValue.End(); ++itemIt)
+    {
+        if constexpr (std::is_same_v<T, double>)
+        {
+            *destination++ = itemIt->GetDouble();
+        }
+        else
+        {
+            *destination++ = itemIt->GetInt64();
+        }
+    }
+
+    value = std::move(result);
+    return true;
+}
+
+std::optional<setting_errc> json_settings_reader::read(const setting_request& request) const
+{
+    const auto jsonValue = find(*request.path);
+    if (jsonValue == nullptr)
+    {
+        return setting_errc::not_found;
+    }
+
+    const auto converted = std::visit([jsonValue](auto destination) { return convert(*jsonValue, *destination); }, request.destination);
+    if (!converted)
+    {
+        return setting_errc::type_mismatch;
+    }
+
+    return std::nullopt;
 }
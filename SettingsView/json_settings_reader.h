@@ -1,21 +1,102 @@
 #pragma once
 
+#include "memory_mapped_file.h"
 #include "settings_reader.h"
 
 #include <rapidjson/document.h>
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 
 class json_settings_reader final : public settings_reader
 {
 public:
     explicit json_settings_reader(rapidjson::Document&& settings);
+    //! Maps the file \p fileName to memory and parses it in-situ, i.e. the string values are not copied
+    //! The std::string_view getter then points directly to the mapped file, i.e. the file must not be modified
+    //! as long as the reader exists (see memory_mapped_file)
+    explicit json_settings_reader(const std::string& fileName);
+    //! As the above, the \p file is mapped (or read by memory_mapped_file::access::copy) by the caller already
+    //! Throws std::invalid_argument when the \p file is null
+    explicit json_settings_reader(std::unique_ptr<memory_mapped_file>&& file);
+    // the member index points to the values of m_settings (the root included), a copy or a moved reader would look up stale addresses
+    json_settings_reader(const json_settings_reader&) = delete;
+    json_settings_reader& operator=(const json_settings_reader&) = delete;
+    json_settings_reader(json_settings_reader&&) = delete;
+    json_settings_reader& operator=(json_settings_reader&&) = delete;
 
-    void get(int& value, const std::string& path) override;
-    void get(int& value, const char* path) override;
+    void get(int& value, const settings_path& path) const override;
 
-    void get(std::string& value, const std::string& path) override;
-    void get(std::string& value, const char* path) override;
+    void get(std::string& value, const settings_path& path) const override;
+    void get(std::string_view& value, const settings_path& path) const override;
+
+    void get(std::int64_t& value, const settings_path& path) const override;
+    void get(double& value, const settings_path& path) const override;
+    void get(bool& value, const settings_path& path) const override;
+    void get(numeric_array<double>& value, const settings_path& path) const override;
+    void get(numeric_array<std::int64_t>& value, const settings_path& path) const override;
+
+    void get(const setting_request* requests, std::size_t count) const override;
+
+    //! The nulls are skipped, the arrays are enumerated item by item
+    void for_each(const visitor_t& visitor) const override;
+    //! All the arrays, the nested ones and the ones of strings or objects included
+    void for_each_array(const array_visitor_t& visitor) const override;
 
 private:
+    //! Reads the single \p request without throwing, the batch ::get and the default settings_reader::try_get call it
+    std::optional<setting_errc> read(const setting_request& request) const override;
+
+    //! Member \c name of the object \c parent
+    struct member_key final
+    {
+        const rapidjson::Value* parent;
+        std::string_view name;
+        //! std::hash<std::string_view> of the \c name, the same as settings_path::token::hash
+        std::size_t nameHash;
+
+        bool operator==(const member_key& other) const noexcept;
+    };
+
+    struct member_key_hash final
+    {
+        std::size_t operator()(const member_key& key) const noexcept;
+    };
+
+    //! Index of the members of all objects in the document, the names point to the strings owned by \c m_settings
+    using member_index_t = std::unordered_map<member_key, const rapidjson::Value*, member_key_hash>;
+
+    //! Validates the parsed document and builds the index
+    void initialize();
+
+    //! Adds the members of \p value (if it is an object) and of all the nested objects to the index
+    void index(const rapidjson::Value& value);
+
+    //! Calls the \p visitor for \p value (if it is a leaf) or for all its nested leaves, \p key is the key of the \p value
+    static void for_each(const rapidjson::Value& value, std::string& key, const visitor_t& visitor);
+    //! Calls the \p visitor for \p value (if it is an array) and for all the nested arrays, \p key is the key of the \p value
+    static void for_each_array(const rapidjson::Value& value, std::string& key, const array_visitor_t& visitor);
+
+    //! Walks the tokens of the \p path, one index lookup per token
+    //! \returns the value at \p path or nullptr if there is no such value
+    const rapidjson::Value* find(const settings_path& path) const;
+
+    //! Converts the \p jsonValue to \p value
+    //! \returns false if the \p jsonValue is not of the requested type
+    static bool convert(const rapidjson::Value& jsonValue, int& value);
+    static bool convert(const rapidjson::Value& jsonValue, std::string& value);
+    static bool convert(const rapidjson::Value& jsonValue, std::string_view& value);
+    static bool convert(const rapidjson::Value& jsonValue, std::int64_t& value);
+    static bool convert(const rapidjson::Value& jsonValue, double& value);
+    static bool convert(const rapidjson::Value& jsonValue, bool& value);
+    //! Validates all the items first, i.e. the \p value is left untouched on mismatch, and then fills the buffer in a single pass
+    template <typename T>
+    static bool convert(const rapidjson::Value& jsonValue, numeric_array<T>& value);
+
+    //! The source of the in-situ parsed document, must outlive the \c m_settings
+    std::unique_ptr<memory_mapped_file> m_file;
     rapidjson::Document m_settings;
-};
\ No newline at end of file
+    member_index_t m_members;
+};
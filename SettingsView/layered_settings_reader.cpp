@@ -0,0 +1,230 @@
+#include "pch.h"
+
+#include "layered_settings_reader.h"
+
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    //! Ordered to look up the std::string_view keys without a copy
+    using key_set = std::set<std::string, std::less<>>;
+
+    //! \returns the keys of the objects and the arrays enclosing the \p key, from the outermost
+    std::vector<std::string_view> parents(std::string_view key)
+    {
+        std::vector<std::string_view> result;
+        for (auto pos = key.find(settings_path::separator); pos != std::string_view::npos; pos = key.find(settings_path::separator, pos + 1))
+        {
+            result.push_back(key.substr(0, pos));
+        }
+
+        return result;
+    }
+
+    //! \returns the key of the value the \p key belongs to, i.e. the outermost of the \p arrays enclosing it or the \p key itself
+    std::string_view value_key(std::string_view key, const key_set& arrays)
+    {
+        for (const auto parent : parents(key))
+        {
+            if (arrays.find(parent) != arrays.end())
+            {
+                return parent;
+            }
+        }
+
+        return key;
+    }
+
+    //! \returns true when the value of the \p key is replaced by the higher layers, i.e. they have a value of the \p key
+    //! or of any of its parents (\p leaves), or the \p key encloses some of their values (\p parentKeys)
+    bool is_shadowed(std::string_view key, const key_set& leaves, const key_set& parentKeys)
+    {
+        if (leaves.find(key) != leaves.end() || parentKeys.find(key) != parentKeys.end())
+        {
+            return true;
+        }
+
+        for (const auto parent : parents(key))
+        {
+            if (leaves.find(parent) != leaves.end())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}  // namespace
+
+layered_settings_reader::layered_settings_reader(std::vector<std::unique_ptr<const settings_reader>>&& layers)
+    : m_layers(std::move(layers))
+{
+    // the settings and the arrays of the higher layers and the keys enclosing them
+    key_set leaves;
+    key_set parentKeys;
+
+    // From the highest precedence, the first value of each key wins. It is also the right order within a layer
+    // that reports a key twice (e.g. duplicate JSON members), its getters return the first one too.
+    for (auto layerIt = m_layers.rbegin(); layerIt != m_layers.rend(); ++layerIt)
+    {
+        if (!*layerIt)
+        {
+            throw std::invalid_argument("layers must not contain null");
+        }
+
+        const auto& layer = **layerIt;
+        key_set arrays;
+        layer.for_each_array([&arrays](std::string_view key) { arrays.emplace(key); });
+
+        // the shadowing is checked against the higher layers only, the keys of this one are added afterwards
+        key_set layerLeaves = arrays;
+        layer.for_each([this, &arrays, &leaves, &parentKeys, &layerLeaves](std::string_view key, const setting_value& value) {
+            if (!is_shadowed(value_key(key, arrays), leaves, parentKeys))
+            {
+                m_settings.emplace(key, value);
+            }
+            layerLeaves.emplace(key);
+        });
+
+        for (const auto& key : arrays)
+        {
+            if (!is_shadowed(value_key(key, arrays), leaves, parentKeys))
+            {
+                m_arrays.emplace(key, &layer);
+            }
+        }
+
+        for (const auto& key : layerLeaves)
+        {
+            for (const auto parent : parents(key))
+            {
+                parentKeys.emplace(parent);
+            }
+        }
+        leaves.merge(layerLeaves);
+    }
+}
+
+void layered_settings_reader::get(int& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(std::string& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(std::string_view& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(std::int64_t& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(double& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(bool& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(numeric_array<double>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(numeric_array<std::int64_t>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void layered_settings_reader::get(const setting_request* requests, std::size_t count) const
+{
+    settings_errors errors;
+    for (auto request = requests; request != requests + count; ++request)
+    {
+        if (const auto code = read(*request))
+        {
+            errors.add(*request, *code);
+        }
+    }
+
+    errors.throw_if_any();
+}
+
+void layered_settings_reader::for_each(const visitor_t& visitor) const
+{
+    for (const auto& setting : m_settings)
+    {
+        visitor(setting.first, setting.second);
+    }
+}
+
+void layered_settings_reader::for_each_array(const array_visitor_t& visitor) const
+{
+    for (const auto& array : m_arrays)
+    {
+        visitor(array.first);
+    }
+}
+
+std::size_t layered_settings_reader::size() const noexcept
+{
+    return m_settings.size();
+}
+
+std::optional<setting_errc> layered_settings_reader::read(const setting_request& request) const
+{
+    const auto settingIt = m_settings.find(request.path->key());
+    if (settingIt == m_settings.end())
+    {
+        const auto arrayIt = m_arrays.find(request.path->key());
+        if (arrayIt == m_arrays.end())
+        {
+            return setting_errc::not_found;
+        }
+
+        const auto isArrayRequest = std::holds_alternative<numeric_array<double>*>(request.destination) ||
+                                    std::holds_alternative<numeric_array<std::int64_t>*>(request.destination);
+        if (!isArrayRequest)
+        {
+            return setting_errc::type_mismatch;
+        }
+
+        // the arrays are not copied by the merge, the winning layer reads them
+        const auto result = arrayIt->second->try_get(&request, 1);
+        if (!result)
+        {
+            return result.error().code;
+        }
+
+        return std::nullopt;
+    }
+
+    const auto converted =
+        std::visit([settingIt](auto destination) { return convert_setting(settingIt->second, *destination); }, request.destination);
+    if (!converted)
+    {
+        return setting_errc::type_mismatch;
+    }
+
+    return std::nullopt;
+}
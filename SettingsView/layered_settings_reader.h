@@ -0,0 +1,62 @@
+#pragma once
+
+#include "settings_reader.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//! Merges several settings sources (e.g. defaults, a base file, host and environment overrides)
+//! The layers are passed from the lowest to the highest precedence, a setting of a later layer overrides
+//! the same setting of all the earlier ones. The merge is per setting, i.e. an object of a later layer
+//! overrides only the members it contains. A setting of a later layer replaces the whole subtree of the same key
+//! of the earlier ones (e.g. "db": "sqlite" drops "db/host") and an object replaces a setting of its key.
+//! An array is a single value, i.e. a later array replaces an earlier one as a whole, items included.
+//!
+//! The winning value of each setting is resolved once by the constructor (see settings_reader::for_each),
+//! a lookup is then a single hash table lookup regardless of the count of the layers.
+//! Build a new instance (and pass it to settings_provider::reload) when any of the layers changes.
+//! The arrays are known from settings_reader::for_each_array, the array getters read the winning array
+//! from its layer. The items of the layers not reporting their arrays are merged one by one.
+class layered_settings_reader final : public settings_reader
+{
+public:
+    //! Throws std::invalid_argument when any of the \p layers is null
+    //! Throws std::logic_error when any of the \p layers cannot enumerate its settings
+    explicit layered_settings_reader(std::vector<std::unique_ptr<const settings_reader>>&& layers);
+
+    void get(int& value, const settings_path& path) const override;
+
+    void get(std::string& value, const settings_path& path) const override;
+    //! The \p value points to the storage of the winning layer
+    void get(std::string_view& value, const settings_path& path) const override;
+
+    void get(std::int64_t& value, const settings_path& path) const override;
+    void get(double& value, const settings_path& path) const override;
+    void get(bool& value, const settings_path& path) const override;
+    void get(numeric_array<double>& value, const settings_path& path) const override;
+    void get(numeric_array<std::int64_t>& value, const settings_path& path) const override;
+
+    void get(const setting_request* requests, std::size_t count) const override;
+
+    void for_each(const visitor_t& visitor) const override;
+    void for_each_array(const array_visitor_t& visitor) const override;
+
+    //! \returns the count of the winning settings, an array counts by its items
+    std::size_t size() const noexcept;
+
+private:
+    //! Reads the single \p request without throwing, the batch ::get and the default settings_reader::try_get call it
+    std::optional<setting_errc> read(const setting_request& request) const override;
+
+    //! The string values of ::m_settings point to the layers, they are kept as long as the table
+    std::vector<std::unique_ptr<const settings_reader>> m_layers;
+    //! The key is settings_path::key
+    std::unordered_map<std::string, setting_value> m_settings;
+    //! The winning arrays, the key is settings_path::key, the value is the layer of the array
+    std::unordered_map<std::string, const settings_reader*> m_arrays;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "utils.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+//! Values of the setting types \c Args, each of them parsed by its first ::get
+//! The sources are read by the provider in a single batch as for settings_view (i.e. a missing setting fails
+//! the get_lazy_view call), only the \c Args::parse calls are deferred. A view with many settings then costs
+//! only the parsing of the settings actually used.
+//! Thread safe, each \c Args::parse runs at most once. The values are shared by the copies of the view.
+template <typename... Args>
+class lazy_settings_view
+{
+public:
+    explicit lazy_settings_view(typename Args::source_type&&... sources);
+
+    //! Returns the value of the setting type \c T, parses it if it is the first call for \c T
+    //! The concurrent first calls wait for the single parse. Throws what \c T::parse threw, the failure
+    //! is kept, i.e. the following calls throw it again rather than parsing a consumed source.
+    //! \tparam T setting type, must be part of the class argument pack \c Args
+    template <typename T, typename = std::enable_if_t<is_any_of<T, Args...>>>
+    const typename T::value_type& get() const;
+
+    //! \returns true if the value of \c T was already parsed (successfully or not)
+    template <typename T, typename = std::enable_if_t<is_any_of<T, Args...>>>
+    bool parsed() const noexcept;
+
+private:
+    template <typename T>
+    struct slot final
+    {
+        explicit slot(typename T::source_type&& input);
+
+        std::once_flag once;
+        std::atomic<bool> done;
+        //! consumed by the parse
+        typename T::source_type source;
+        std::optional<typename T::value_type> value;
+        std::exception_ptr error;
+    };
+
+    using slots_t = std::tuple<slot<Args>...>;
+
+    std::shared_ptr<slots_t> m_slots;
+};
+
+template <typename... Args>
+template <typename T>
+lazy_settings_view<Args...>::slot<T>::slot(typename T::source_type&& input)
+    : done{false}
+    , source(std::move(input))
+{
+}
+
+template <typename... Args>
+lazy_settings_view<Args...>::lazy_settings_view(typename Args::source_type&&... sources)
+    : m_slots(std::make_shared<slots_t>(std::move(sources)...))
+{
+}
+
+template <typename... Args>
+template <typename T, typename>
+const typename T::value_type& lazy_settings_view<Args...>::get() const
+{
+    auto& item = std::get<pack_index_v<T, Args...>>(*m_slots);
+    std::call_once(item.once, [&item]() {
+        try
+        {
+            item.value.emplace(T::parse(std::move(item.source)));
+        }
+        catch (...)
+        {
+            item.error = std::current_exception();
+        }
+        item.done.store(true, std::memory_order_release);
+    });
+
+    if (item.error)
+    {
+        std::rethrow_exception(item.error);
+    }
+
+    return *item.value;
+}
+
+template <typename... Args>
+template <typename T, typename>
+bool lazy_settings_view<Args...>::parsed() const noexcept
+{
+    return std::get<pack_index_v<T, Args...>>(*m_slots).done.load(std::memory_order_acquire);
+}
@@ -18,11 +18,11 @@ int main()
         auto settingsReader = std::make_unique<json_settings_reader>(std::move(settingsJson));
         settings_provider provider(std::move(settingsReader));
 
-        auto token = provider.add_observer([](const std::string& consumer, const std::vector<std::string>& types) {
+        auto token = provider.add_observer([](const std::string& consumer, setting_descriptors descriptors) {
             std::cout << "consumer: '" << consumer << "' requested:";
-            for (const auto& type : types)
+            for (const auto& descriptor : descriptors)
             {
-                std::cout << ' ' << type << ',';
+                std::cout << ' ' << descriptor.path << " (" << setting_kind_name(descriptor.kind) << "),";
             }
             std::cout << "\n\n";
         });
@@ -0,0 +1,177 @@
+#include "pch.h"
+
+#include "memory_mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::size_t page_size()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    [[noreturn]] void throw_error(const std::string& fileName, const char* what)
+    {
+        throw std::runtime_error("Cannot " + std::string(what) + " file '" + fileName + "'");
+    }
+}  // namespace
+
+memory_mapped_file::memory_mapped_file(const std::string& fileName, access fileAccess)
+    : m_data{nullptr}
+    , m_size{0}
+    , m_mapped{false}
+{
+    if (fileAccess == access::copy)
+    {
+        read_to_buffer(fileName);
+        return;
+    }
+
+#ifdef _WIN32
+    const auto file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw_error(fileName, "open");
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw_error(fileName, "read size of");
+    }
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+
+    if (m_size % page_size() != 0)
+    {
+        const auto mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            throw_error(fileName, "map");
+        }
+
+        // the view keeps the mapping alive
+        m_data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        CloseHandle(mapping);
+        if (m_data == nullptr)
+        {
+            throw_error(fileName, "map");
+        }
+        m_mapped = true;
+        return;
+    }
+
+    CloseHandle(file);
+#else
+    const auto file = open(fileName.c_str(), O_RDONLY);
+    if (file == -1)
+    {
+        throw_error(fileName, "open");
+    }
+
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) == -1)
+    {
+        close(file);
+        throw_error(fileName, "read size of");
+    }
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+
+    if (m_size % page_size() != 0)
+    {
+        // the mapping stays valid after the descriptor is closed
+        const auto data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED)
+        {
+            throw_error(fileName, "map");
+        }
+
+        m_data = static_cast<char*>(data);
+        m_mapped = true;
+        return;
+    }
+
+    close(file);
+#endif
+
+    read_to_buffer(fileName);
+}
+
+memory_mapped_file::~memory_mapped_file()
+{
+    if (!m_mapped)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, m_size);
+#endif
+}
+
+char* memory_mapped_file::data() noexcept
+{
+    return m_data;
+}
+
+const char* memory_mapped_file::data() const noexcept
+{
+    return m_data;
+}
+
+std::size_t memory_mapped_file::size() const noexcept
+{
+    return m_size;
+}
+
+void memory_mapped_file::read_to_buffer(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+    {
+        throw_error(fileName, "open");
+    }
+
+    // the size known so far is a hint only, the file is read until its end
+    constexpr std::size_t chunkSize = 64 * 1024;
+    m_buffer.resize(m_size + chunkSize);
+    std::size_t size = 0;
+    while (file.read(m_buffer.data() + size, static_cast<std::streamsize>(m_buffer.size() - size)))
+    {
+        size = m_buffer.size();
+        m_buffer.resize(m_buffer.size() + chunkSize);
+    }
+    if (file.bad())
+    {
+        throw_error(fileName, "read");
+    }
+    size += static_cast<std::size_t>(file.gcount());
+
+    m_buffer.resize(size + 1);
+    m_buffer[size] = '\0';
+    m_data = m_buffer.data();
+    m_size = size;
+}
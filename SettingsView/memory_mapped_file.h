@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! Read-only file mapped to memory copy-on-write, i.e. the content can be modified in memory (e.g. parsed in-situ)
+//! without affecting the file nor the other processes mapping it.
+//! The content is always followed by '\0', i.e. data()[size()] == '\0'.
+//!
+//! The mapped file must not be modified while it is mapped: the pages not written in memory yet follow the file,
+//! and an access past the end of a truncated file raises SIGBUS. Read a file that may be edited in place
+//! (e.g. the one of settings_file_watcher) by access::copy.
+class memory_mapped_file final
+{
+public:
+    enum class access
+    {
+        //! maps the file, it must not be modified while mapped
+        map,
+        //! reads the file to an owned buffer, i.e. the content is a snapshot no later modification affects
+        copy
+    };
+
+    //! Maps the file by default, see access::map
+    //! Throws std::runtime_error when the file cannot be opened, mapped or read
+    explicit memory_mapped_file(const std::string& fileName, access fileAccess = access::map);
+    // the mapping is owned exclusively
+    memory_mapped_file(const memory_mapped_file&) = delete;
+    memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+    ~memory_mapped_file();
+
+    char* data() noexcept;
+    const char* data() const noexcept;
+
+    //! \returns the size of the file, not including the terminating '\0'
+    std::size_t size() const noexcept;
+
+private:
+    //! The pages past the end of the file are zero-filled, unless the file size is a multiple of the page size.
+    //! Such file (and the empty one) is read into a heap buffer instead, as is any file read by access::copy.
+    //! The file is read up to its end, i.e. its size may change since it was opened.
+    void read_to_buffer(const std::string& fileName);
+
+    char* m_data;
+    std::size_t m_size;
+    bool m_mapped;
+    std::vector<char> m_buffer;
+};
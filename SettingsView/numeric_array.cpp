@@ -0,0 +1,74 @@
+#include "pch.h"
+
+#include "numeric_array.h"
+
+#include <cstring>
+
+namespace
+{
+    //! 2^52 + 2^51, adding an integer of (-2^51, 2^51) to its mantissa yields a double that is exactly the integer plus this
+    constexpr double magicReal = 6755399441055744.0;
+    constexpr std::uint64_t magicBits = 0x4338000000000000ull;
+
+    //! Count of the elements converted together, a block failing the range check is converted again by the scalar loop
+    constexpr std::size_t blockSize = 256;
+
+    //! int64 to double by an integer add and a real subtract, both vectorize on SSE2 and AVX2 unlike the conversion
+    //! instruction (cvtqq2pd is AVX-512DQ only)
+    //! \returns false if any of the integers is out of (-2^51, 2^51), i.e. the \p destination is not exact
+    bool convert_magic(const std::int64_t* source, std::size_t count, double* destination) noexcept
+    {
+        std::uint64_t outOfRange = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto integer = static_cast<std::uint64_t>(source[i]);
+            // x + 2^51 is in [0, 2^52) for the integers in range, any other one sets a bit of 2^52 or above (the sum wraps for the negative ones)
+            outOfRange |= (integer + (1ull << 51)) & ~((1ull << 52) - 1);
+
+            const auto bits = integer + magicBits;
+            double biased;
+            std::memcpy(&biased, &bits, sizeof(biased));
+            destination[i] = biased - magicReal;
+        }
+
+        return outOfRange == 0;
+    }
+}  // namespace
+
+void convert_numbers(const double* source, std::size_t count, double* destination) noexcept
+{
+    if (count != 0)
+    {
+        std::memcpy(destination, source, count * sizeof(double));
+    }
+}
+
+void convert_numbers(const std::int64_t* source, std::size_t count, std::int64_t* destination) noexcept
+{
+    if (count != 0)
+    {
+        std::memcpy(destination, source, count * sizeof(std::int64_t));
+    }
+}
+
+void convert_numbers(const std::int64_t* source, std::size_t count, double* destination) noexcept
+{
+    std::size_t i = 0;
+    for (; i + blockSize <= count; i += blockSize)
+    {
+        if (convert_magic(source + i, blockSize, destination + i))
+        {
+            continue;
+        }
+
+        for (auto j = i; j < i + blockSize; ++j)
+        {
+            destination[j] = static_cast<double>(source[j]);
+        }
+    }
+
+    for (; i < count; ++i)
+    {
+        destination[i] = static_cast<double>(source[i]);
+    }
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+//! Contiguous array of numbers in a single buffer aligned to the cache line, i.e. it can be processed by SIMD loads
+//! The value type of the array settings (see settings_reader). Copying copies the elements.
+//! \tparam T double or std::int64_t
+template <typename T>
+class numeric_array final
+{
+    static_assert(is_any_of<T, double, std::int64_t>, "numeric_array supports double and std::int64_t only");
+
+public:
+    static constexpr std::size_t alignment = 64;
+
+    using value_type = T;
+
+    numeric_array() noexcept;
+    //! The elements are not initialized, the readers fill them in bulk
+    explicit numeric_array(std::size_t size);
+    numeric_array(std::initializer_list<T> values);
+
+    numeric_array(const numeric_array& other);
+    //! The \p other is left empty
+    numeric_array(numeric_array&& other) noexcept;
+    numeric_array& operator=(const numeric_array& other);
+    numeric_array& operator=(numeric_array&& other) noexcept;
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    T* data() noexcept;
+    const T* data() const noexcept;
+
+    const T* begin() const noexcept;
+    const T* end() const noexcept;
+
+    const T& operator[](std::size_t index) const noexcept;
+
+    bool operator==(const numeric_array& other) const noexcept;
+    bool operator!=(const numeric_array& other) const noexcept;
+
+private:
+    struct deleter final
+    {
+        void operator()(T* data) const noexcept;
+    };
+
+    std::unique_ptr<T[], deleter> m_data;
+    std::size_t m_size;
+};
+
+//! Bulk conversion kernels filling numeric_array from a contiguous source
+//! The source and the destination must not overlap, the loops are written so that the compilers vectorize them.
+void convert_numbers(const double* source, std::size_t count, double* destination) noexcept;
+void convert_numbers(const std::int64_t* source, std::size_t count, std::int64_t* destination) noexcept;
+//! The integers beyond +-2^53 are rounded as by static_cast
+void convert_numbers(const std::int64_t* source, std::size_t count, double* destination) noexcept;
+
+template <typename T>
+numeric_array<T>::numeric_array() noexcept
+    : m_size{0}
+{
+}
+
+template <typename T>
+numeric_array<T>::numeric_array(std::size_t size)
+    : m_data{size == 0 ? nullptr : static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{alignment}))}
+    , m_size{size}
+{
+}
+
+template <typename T>
+numeric_array<T>::numeric_array(std::initializer_list<T> values)
+    : numeric_array(values.size())
+{
+    std::copy(values.begin(), values.end(), data());
+}
+
+template <typename T>
+numeric_array<T>::numeric_array(const numeric_array& other)
+    : numeric_array(other.size())
+{
+    std::copy(other.begin(), other.end(), data());
+}
+
+template <typename T>
+numeric_array<T>::numeric_array(numeric_array&& other) noexcept
+    : m_data{std::move(other.m_data)}
+    , m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+template <typename T>
+numeric_array<T>& numeric_array<T>::operator=(const numeric_array& other)
+{
+    if (this != &other)
+    {
+        *this = numeric_array(other);
+    }
+
+    return *this;
+}
+
+template <typename T>
+numeric_array<T>& numeric_array<T>::operator=(numeric_array&& other) noexcept
+{
+    m_data = std::move(other.m_data);
+    m_size = std::exchange(other.m_size, 0);
+
+    return *this;
+}
+
+template <typename T>
+std::size_t numeric_array<T>::size() const noexcept
+{
+    return m_size;
+}
+
+template <typename T>
+bool numeric_array<T>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+template <typename T>
+T* numeric_array<T>::data() noexcept
+{
+    return m_data.get();
+}
+
+template <typename T>
+const T* numeric_array<T>::data() const noexcept
+{
+    return m_data.get();
+}
+
+template <typename T>
+const T* numeric_array<T>::begin() const noexcept
+{
+    return m_data.get();
+}
+
+template <typename T>
+const T* numeric_array<T>::end() const noexcept
+{
+    return m_data.get() + m_size;
+}
+
+template <typename T>
+const T& numeric_array<T>::operator[](std::size_t index) const noexcept
+{
+    return m_data[index];
+}
+
+template <typename T>
+bool numeric_array<T>::operator==(const numeric_array& other) const noexcept
+{
+    return std::equal(begin(), end(), other.begin(), other.end());
+}
+
+template <typename T>
+bool numeric_array<T>::operator!=(const numeric_array& other) const noexcept
+{
+    return !(*this == other);
+}
+
+template <typename T>
+void numeric_array<T>::deleter::operator()(T* data) const noexcept
+{
+    ::operator delete(data, std::align_val_t{alignment});
+}
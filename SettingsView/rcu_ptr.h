@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Publishes immutable values of type T to concurrent readers (read-copy-update)
+// Readers never take a lock nor wait for a writer, the value they loaded stays alive
+// as long as they hold the returned std::shared_ptr.
+// Writers are serialized by an internal mutex.
+//
+// The published value is owned by a node that is retired when a new value is stored. A reader announces
+// the node it is copying the std::shared_ptr from in its own reader slot (a hazard pointer), the threads
+// are assigned the slots round robin as sharded_shared_mutex does, i.e. the readers running on different
+// cores do not write the same cache line. The writer releases a retired node (and so its reference to the value)
+// right away unless a reader announces it. Such a node is kept only for the few instructions of the copy, it is
+// released by the next store (or the destruction), i.e. at most one node per reader slot is kept retired.
+//
+// Example usage:
+//
+// rcu_ptr<std::string> p{std::make_shared<const std::string>("first")};
+// auto current = p.load();                // *current == "first"
+// p.store(std::make_shared<const std::string>("second"));
+// // current is still valid and still "first"
+template <typename T>
+class rcu_ptr final
+{
+public:
+    using value_t = T;
+    using pointer_t = std::shared_ptr<const value_t>;
+
+    explicit rcu_ptr(pointer_t value = pointer_t{});
+    // the readers can hold the loaded pointer, copy or move would be confusing
+    rcu_ptr(const rcu_ptr&) = delete;
+    rcu_ptr& operator=(const rcu_ptr&) = delete;
+
+    // thread safe, lock free
+    pointer_t load() const noexcept;
+
+    // thread safe
+    void store(pointer_t value);
+
+    // thread safe
+    // F is called with the currently published value (const pointer_t&) and must return the value to be published
+    // no other writer can publish in the meantime, i.e. F can be used to derive the next value from the current one
+    template <typename F>
+    pointer_t update(F f);
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    struct node final
+    {
+        pointer_t value;
+    };
+
+    struct alignas(cache_line_size) reader_slot final
+    {
+        // the node a reader is copying the value from, nullptr when the slot is free
+        std::atomic<const node*> hazard{nullptr};
+    };
+
+    // must be called with m_writerMtx locked
+    void publish(pointer_t value);
+
+    // releases the retired nodes not announced by any reader, must be called with m_writerMtx locked
+    void reclaim();
+
+    std::size_t m_slotsMask;
+    std::unique_ptr<reader_slot[]> m_slots;
+    std::atomic<const node*> m_current;
+
+    std::mutex m_writerMtx;
+    std::unique_ptr<node> m_currentOwner;
+    std::vector<std::unique_ptr<node>> m_retired;
+};
+
+template <typename T>
+rcu_ptr<T>::rcu_ptr(pointer_t value)
+    : m_slotsMask{0}
+    , m_current{nullptr}
+    , m_currentOwner{std::make_unique<node>(node{std::move(value)})}
+{
+    const auto threadsCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    std::size_t slotsCount = 1;
+    while (slotsCount < threadsCount)
+    {
+        slotsCount *= 2;
+    }
+
+    m_slotsMask = slotsCount - 1;
+    m_slots = std::make_unique<reader_slot[]>(slotsCount);
+    m_current.store(m_currentOwner.get());
+}
+
+template <typename T>
+typename rcu_ptr<T>::pointer_t rcu_ptr<T>::load() const noexcept
+{
+    static std::atomic<std::size_t> nextThreadIndex{0};
+    thread_local const std::size_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+    // the slot is normally free, it is shared only when there are more threads than slots
+    for (auto i = threadIndex;; ++i)
+    {
+        auto& slot = m_slots[i & m_slotsMask];
+        auto current = m_current.load();
+        const node* expected = nullptr;
+        if (!slot.hazard.compare_exchange_strong(expected, current))
+        {
+            continue;
+        }
+
+        // seq_cst ordering guarantees that either the writer sees the announced node
+        // or the reader sees the newly published one and announces it instead
+        for (auto published = m_current.load(); published != current; published = m_current.load())
+        {
+            current = published;
+            slot.hazard.store(current);
+        }
+
+        pointer_t value = current->value;
+        slot.hazard.store(nullptr, std::memory_order_release);
+
+        return value;
+    }
+}
+
+template <typename T>
+void rcu_ptr<T>::store(pointer_t value)
+{
+    std::lock_guard<std::mutex> lock{m_writerMtx};
+    publish(std::move(value));
+}
+
+template <typename T>
+template <typename F>
+typename rcu_ptr<T>::pointer_t rcu_ptr<T>::update(F f)
+{
+    std::lock_guard<std::mutex> lock{m_writerMtx};
+    pointer_t value = f(static_cast<const pointer_t&>(m_currentOwner->value));
+    publish(value);
+
+    return value;
+}
+
+template <typename T>
+void rcu_ptr<T>::publish(pointer_t value)
+{
+    auto next = std::make_unique<node>(node{std::move(value)});
+    m_current.store(next.get());
+    m_retired.push_back(std::move(m_currentOwner));
+    m_currentOwner = std::move(next);
+
+    reclaim();
+}
+
+template <typename T>
+void rcu_ptr<T>::reclaim()
+{
+    const auto announced = [this](const std::unique_ptr<node>& retired) {
+        for (std::size_t i = 0; i <= m_slotsMask; ++i)
+        {
+            if (m_slots[i].hazard.load() == retired.get())
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), [&announced](const auto& retired) { return !announced(retired); }),
+                    m_retired.end());
+}
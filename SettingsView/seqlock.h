@@ -0,0 +1,166 @@
+#pragma once
+
+#include "monitor.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+// Sequence lock, the writers are serialized by lock/unlock (i.e. it can be used with std::lock_guard),
+// the readers do not lock at all, they read optimistically and retry when a writer interfered:
+//
+// seqlock lock;
+// std::uint64_t sequence;
+// do
+// {
+//     sequence = lock.read_begin();
+//     ... copy the protected data (using atomics, a plain read would be a data race)
+// } while (lock.read_retry(sequence));
+//
+// The readers never write a shared cache line, i.e. they do not slow down each other.
+// Use it as the Mtx of monitor<T, seqlock> for small trivially copyable values.
+class seqlock final
+{
+public:
+    seqlock() = default;
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    void lock()
+    {
+        m_writerMtx.lock();
+        // odd sequence marks a write in progress, the release fence orders it before the data stores
+        m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void unlock()
+    {
+        m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        m_writerMtx.unlock();
+    }
+
+    //! \returns the sequence to be passed to ::read_retry, waits while a write is in progress
+    std::uint64_t read_begin() const
+    {
+        auto sequence = m_sequence.load(std::memory_order_acquire);
+        while (sequence % 2 != 0)
+        {
+            std::this_thread::yield();
+            sequence = m_sequence.load(std::memory_order_acquire);
+        }
+
+        return sequence;
+    }
+
+    //! \returns true if a write interfered with the read started by ::read_begin that returned \p sequence
+    bool read_retry(std::uint64_t sequence) const
+    {
+        // the acquire fence orders the data loads before the sequence check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_sequence.load(std::memory_order_relaxed) != sequence;
+    }
+
+private:
+    std::atomic<std::uint64_t> m_sequence{0};
+    std::mutex m_writerMtx;
+};
+
+// monitor specialization reading without any lock, for small trivially copyable values
+// The value is stored in atomic words, the readers copy it and retry if a writer modified it meanwhile.
+// Unlike the general monitor the read-only F (invocable with const T) receives a copy of the value,
+// i.e. it must not return a reference to it. The writers are serialized and see the value itself.
+template <typename T>
+class monitor<T, seqlock> final
+{
+public:
+    using value_t = T;
+    using mutex_t = seqlock;
+
+    static_assert(std::is_trivially_copyable_v<value_t>, "monitor<T, seqlock> requires trivially copyable T");
+    static_assert(std::is_default_constructible_v<value_t>, "monitor<T, seqlock> requires default constructible T");
+
+    monitor(value_t value = value_t{});
+    monitor(const monitor&) = delete;
+
+    template <typename F>
+    decltype(auto) operator()(F f) const
+    {
+        if constexpr (std::is_invocable_v<F, const T>)
+        {
+            const value_t value = load();
+            return f(value);
+        }
+        else
+        {
+            std::lock_guard<mutex_t> lock{m_lock};
+            if constexpr (std::is_void_v<std::invoke_result_t<F, value_t&>>)
+            {
+                f(m_value);
+                store(m_value);
+            }
+            else
+            {
+                auto result = f(m_value);
+                store(m_value);
+                return result;
+            }
+        }
+    }
+
+private:
+    using word_t = std::uintptr_t;
+    static constexpr std::size_t words_count = (sizeof(value_t) + sizeof(word_t) - 1) / sizeof(word_t);
+
+    value_t load() const;
+    // must be called with m_lock locked
+    void store(const value_t& value) const;
+
+    mutable mutex_t m_lock;
+    //! the copy read by the readers
+    mutable std::array<std::atomic<word_t>, words_count> m_words;
+    //! the value itself, accessed by the writers only
+    mutable value_t m_value;
+};
+
+template <typename T>
+monitor<T, seqlock>::monitor(value_t value)
+    : m_value{value}
+{
+    std::lock_guard<mutex_t> lock{m_lock};
+    store(m_value);
+}
+
+template <typename T>
+typename monitor<T, seqlock>::value_t monitor<T, seqlock>::load() const
+{
+    std::array<word_t, words_count> words;
+    std::uint64_t sequence;
+    do
+    {
+        sequence = m_lock.read_begin();
+        for (std::size_t i = 0; i < words_count; ++i)
+        {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+    } while (m_lock.read_retry(sequence));
+
+    value_t value;
+    std::memcpy(&value, words.data(), sizeof(value_t));
+    return value;
+}
+
+template <typename T>
+void monitor<T, seqlock>::store(const value_t& value) const
+{
+    std::array<word_t, words_count> words{};
+    std::memcpy(words.data(), &value, sizeof(value_t));
+    for (std::size_t i = 0; i < words_count; ++i)
+    {
+        m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "numeric_array.h"
+#include "utils.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//! Type of the value a setting is read as, i.e. of its \c source_type
+enum class setting_kind : std::uint8_t
+{
+    integer,
+    string,
+    integer64,
+    real,
+    boolean,
+    real_array,
+    integer64_array
+};
+
+template <typename T>
+constexpr setting_kind setting_kind_of()
+{
+    static_assert(is_any_of<T, int, std::string, std::string_view, std::int64_t, double, bool, numeric_array<double>, numeric_array<std::int64_t>>,
+                  "unsupported source_type");
+
+    if constexpr (std::is_same_v<T, int>)
+    {
+        return setting_kind::integer;
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>)
+    {
+        return setting_kind::integer64;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return setting_kind::real;
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return setting_kind::boolean;
+    }
+    else if constexpr (std::is_same_v<T, numeric_array<double>>)
+    {
+        return setting_kind::real_array;
+    }
+    else if constexpr (std::is_same_v<T, numeric_array<std::int64_t>>)
+    {
+        return setting_kind::integer64_array;
+    }
+    else
+    {
+        return setting_kind::string;
+    }
+}
+
+//! \returns the name of the \p kind, the same as setting_type_name of the corresponding type
+constexpr std::string_view setting_kind_name(setting_kind kind) noexcept
+{
+    switch (kind)
+    {
+    case setting_kind::integer:
+        return "int";
+    case setting_kind::string:
+        return "string";
+    case setting_kind::integer64:
+        return "int64";
+    case setting_kind::real:
+        return "double";
+    case setting_kind::boolean:
+        return "bool";
+    case setting_kind::real_array:
+        return "double array";
+    case setting_kind::integer64_array:
+        return "int64 array";
+    }
+
+    return "unknown";
+}
+
+//! Compile-time description of a setting type
+struct setting_descriptor final
+{
+    //! type_id_v of the setting type
+    const void* id;
+    //! the setting type path, i.e. \c T::path
+    std::string_view path;
+    setting_kind kind;
+};
+
+template <typename T>
+constexpr setting_descriptor describe_setting() noexcept
+{
+    return {type_id_v<T>, T::path, setting_kind_of<typename T::source_type>()};
+}
+
+//! Descriptors of the setting types \c Args in the order of the pack, one static instance per pack
+template <typename... Args>
+inline constexpr std::array<setting_descriptor, sizeof...(Args)> setting_descriptors_v{{describe_setting<Args>()...}};
+
+//! Non-owning view of a static descriptor array, cheap to copy
+class setting_descriptors final
+{
+public:
+    constexpr setting_descriptors(const setting_descriptor* data, std::size_t size) noexcept
+        : m_data{data}
+        , m_size{size}
+    {
+    }
+
+    constexpr const setting_descriptor* begin() const noexcept
+    {
+        return m_data;
+    }
+
+    constexpr const setting_descriptor* end() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    constexpr const setting_descriptor& operator[](std::size_t index) const noexcept
+    {
+        return m_data[index];
+    }
+
+private:
+    const setting_descriptor* m_data;
+    std::size_t m_size;
+};
+
+//! \returns the view of setting_descriptors_v of \c Args
+template <typename... Args>
+constexpr setting_descriptors setting_descriptors_of() noexcept
+{
+    return {setting_descriptors_v<Args...>.data(), sizeof...(Args)};
+}
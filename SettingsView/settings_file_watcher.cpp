@@ -0,0 +1,186 @@
+#include "pch.h"
+
+#include "settings_file_watcher.h"
+
+#include "json_settings_reader.h"
+#include "memory_mapped_file.h"
+#include "utils.h"
+
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#endif
+
+settings_file_watcher::settings_file_watcher(settings_provider& provider,
+                                             std::string fileName,
+                                             std::chrono::milliseconds debounce,
+                                             reader_factory_t readerFactory,
+                                             error_callback_t errorCallback)
+    : m_provider(provider)
+    , m_fileName(std::move(fileName))
+    , m_debounce{debounce}
+    , m_readerFactory{std::move(readerFactory)}
+    , m_errorCallback{std::move(errorCallback)}
+    , m_contentHash{content_hash(memory_mapped_file(m_fileName, memory_mapped_file::access::copy))}
+{
+    if (!m_readerFactory)
+    {
+        m_readerFactory = [](const std::string&, std::unique_ptr<memory_mapped_file>&& content) {
+            return std::make_unique<json_settings_reader>(std::move(content));
+        };
+    }
+
+#ifdef __linux__
+    const auto path = std::filesystem::absolute(m_fileName);
+    m_name = path.filename().string();
+
+    m_inotifyFd = inotify_init1(IN_CLOEXEC);
+    if (m_inotifyFd == -1)
+    {
+        throw std::runtime_error("Cannot watch file '" + m_fileName + "'");
+    }
+
+    // the directory is watched, an editor may replace the file instead of writing it
+    const auto mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE;
+    if (inotify_add_watch(m_inotifyFd, path.parent_path().c_str(), mask) == -1)
+    {
+        close(m_inotifyFd);
+        throw std::runtime_error("Cannot watch file '" + m_fileName + "'");
+    }
+
+    m_stopFd = eventfd(0, EFD_CLOEXEC);
+    if (m_stopFd == -1)
+    {
+        close(m_inotifyFd);
+        throw std::runtime_error("Cannot watch file '" + m_fileName + "'");
+    }
+#else
+    m_stopping = false;
+    m_lastWriteTime = std::filesystem::last_write_time(m_fileName);
+#endif
+
+    m_thread = std::thread([this]() { run(); });
+}
+
+settings_file_watcher::~settings_file_watcher()
+{
+#ifdef __linux__
+    const std::uint64_t stop = 1;
+    // cannot fail, the counter cannot overflow with a single write
+    [[maybe_unused]] const auto written = write(m_stopFd, &stop, sizeof(stop));
+#else
+    {
+        std::lock_guard<std::mutex> lock{m_stopMtx};
+        m_stopping = true;
+    }
+    m_stopCv.notify_one();
+#endif
+
+    m_thread.join();
+
+#ifdef __linux__
+    close(m_stopFd);
+    close(m_inotifyFd);
+#endif
+}
+
+std::uint64_t settings_file_watcher::content_hash(const memory_mapped_file& content)
+{
+    return fnv1a_64(std::string_view(content.data(), content.size()));
+}
+
+void settings_file_watcher::run()
+{
+    while (wait_for_change())
+    {
+        reload_if_changed();
+    }
+}
+
+#ifdef __linux__
+bool settings_file_watcher::wait_for_change()
+{
+    std::array<pollfd, 2> fds{{{m_inotifyFd, POLLIN, 0}, {m_stopFd, POLLIN, 0}}};
+    auto changed = false;
+
+    while (true)
+    {
+        // blocks until the first change, then until the debounce period passes without any
+        const auto timeout = changed ? static_cast<int>(m_debounce.count()) : -1;
+        if (poll(fds.data(), fds.size(), timeout) == -1)
+        {
+            continue;
+        }
+
+        if (fds[1].revents != 0)
+        {
+            return false;
+        }
+
+        if (fds[0].revents == 0)
+        {
+            // the debounce period passed
+            return true;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        const auto length = read(m_inotifyFd, buffer, sizeof(buffer));
+        for (auto offset = ssize_t{0}; offset < length;)
+        {
+            const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            changed = changed || (event->len != 0 && m_name == event->name);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+}
+#else
+bool settings_file_watcher::wait_for_change()
+{
+    std::unique_lock<std::mutex> lock{m_stopMtx};
+    while (!m_stopCv.wait_for(lock, m_debounce, [this]() { return m_stopping; }))
+    {
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(m_fileName, error);
+        if (!error && writeTime != m_lastWriteTime)
+        {
+            m_lastWriteTime = writeTime;
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+void settings_file_watcher::reload_if_changed()
+{
+    try
+    {
+        // hashed before the reader parses it (e.g. in-situ)
+        auto content = std::make_unique<memory_mapped_file>(m_fileName, memory_mapped_file::access::copy);
+        const auto hash = content_hash(*content);
+        if (hash == m_contentHash)
+        {
+            return;
+        }
+
+        m_provider.reload(m_readerFactory(m_fileName, std::move(content)));
+        m_contentHash = hash;
+    }
+    catch (const std::exception& ex)
+    {
+        if (m_errorCallback)
+        {
+            m_errorCallback("Cannot reload settings from '" + m_fileName + "': " + ex.what());
+        }
+    }
+}
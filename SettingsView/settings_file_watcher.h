@@ -0,0 +1,85 @@
+#pragma once
+
+#include "memory_mapped_file.h"
+#include "settings_provider.h"
+#include "settings_reader.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef __linux__
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#endif
+
+//! Reloads the settings of a settings_provider when the settings file changes
+//! The changes are detected by inotify on Linux (the directory is watched, i.e. the editors replacing the file
+//! by rename are detected as well), elsewhere the modification time is polled with the debounce period.
+//! A change is handled after no other change came for the debounce period, the file is parsed on the watcher's
+//! own thread and swapped into the provider. A file with the same content (hash) as the last loaded one is not
+//! reloaded, a file that cannot be parsed leaves the previous settings in place. The file is read once per change
+//! to an owned buffer (see memory_mapped_file::access::copy), the reader parses the same bytes that were hashed,
+//! i.e. a write racing with the reload cannot be missed, and no later edit of the file affects the published reader.
+//! The watched file is edited in place, the initial reader of the \p provider should not map it either.
+class settings_file_watcher final
+{
+public:
+    //! Creates the reader of the \p content read from the file \p fileName, it must read the \p content rather than the file
+    using reader_factory_t = std::function<std::unique_ptr<settings_reader>(const std::string& fileName,
+                                                                            std::unique_ptr<memory_mapped_file>&& content)>;
+    using error_callback_t = std::function<void(const std::string& message)>;
+
+    //! The \p provider must outlive the watcher, the \p fileName is expected to be the file its settings were read from
+    //! The \p readerFactory creates the reader of the changed file, json_settings_reader by default.
+    //! The \p errorCallback is called from the watcher's thread when the changed file cannot be loaded.
+    //! Throws std::runtime_error when the file cannot be read or watched
+    settings_file_watcher(settings_provider& provider,
+                          std::string fileName,
+                          std::chrono::milliseconds debounce = std::chrono::milliseconds(100),
+                          reader_factory_t readerFactory = nullptr,
+                          error_callback_t errorCallback = nullptr);
+    settings_file_watcher(const settings_file_watcher&) = delete;
+    settings_file_watcher& operator=(const settings_file_watcher&) = delete;
+    //! Stops watching, waits for the reload in progress
+    ~settings_file_watcher();
+
+private:
+    //! \returns the fnv1a_64 hash of the \p content
+    static std::uint64_t content_hash(const memory_mapped_file& content);
+
+    void run();
+
+    //! Blocks until a change of the file followed by the debounce period of silence
+    //! \returns false when the watcher is stopping
+    bool wait_for_change();
+
+    void reload_if_changed();
+
+    settings_provider& m_provider;
+    const std::string m_fileName;
+    const std::chrono::milliseconds m_debounce;
+    reader_factory_t m_readerFactory;
+    error_callback_t m_errorCallback;
+    //! hash of the last loaded content, accessed by the watcher's thread only after construction
+    std::uint64_t m_contentHash;
+
+#ifdef __linux__
+    int m_inotifyFd;
+    //! eventfd signalled by the destructor
+    int m_stopFd;
+    //! file name without the directory, the events of the watched directory are filtered by it
+    std::string m_name;
+#else
+    std::mutex m_stopMtx;
+    std::condition_variable m_stopCv;
+    bool m_stopping;
+    std::filesystem::file_time_type m_lastWriteTime;
+#endif
+
+    std::thread m_thread;
+};
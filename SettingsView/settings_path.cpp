@@ -0,0 +1,146 @@
+#include "pch.h"
+
+#include "settings_path.h"
+
+#include "utils.h"
+
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+    std::string unescape(std::string_view escaped)
+    {
+        std::string name;
+        name.reserve(escaped.size());
+        for (std::size_t i = 0; i < escaped.size(); ++i)
+        {
+            if (escaped[i] != '~')
+            {
+                name += escaped[i];
+                continue;
+            }
+
+            const auto next = i + 1 < escaped.size() ? escaped[i + 1] : '\0';
+            if (next != '0' && next != '1')
+            {
+                throw std::invalid_argument("Invalid escape sequence in path '" + std::string(escaped) + "'");
+            }
+            name += next == '0' ? '~' : '/';
+            ++i;
+        }
+
+        return name;
+    }
+
+    std::size_t to_index(const std::string& name)
+    {
+        // leading zeros are not allowed by JSON Pointer, such token can be only a member name
+        if (name.empty() || (name.size() > 1 && name.front() == '0'))
+        {
+            return settings_path::token::no_index;
+        }
+
+        std::size_t index = 0;
+        for (const auto c : name)
+        {
+            if (c < '0' || c > '9' || index > (settings_path::token::no_index - 9) / 10)
+            {
+                return settings_path::token::no_index;
+            }
+            index = index * 10 + static_cast<std::size_t>(c - '0');
+        }
+
+        return index;
+    }
+}  // namespace
+
+settings_path::settings_path(const char* path)
+    : settings_path(std::string_view(path))
+{
+}
+
+settings_path::settings_path(const std::string& path)
+    : settings_path(std::string_view(path))
+{
+}
+
+settings_path::settings_path(std::string_view path)
+    : m_path(path)
+    , m_keyHash{0}
+{
+    if (!path.empty() && path.front() == separator)
+    {
+        path.remove_prefix(1);
+    }
+
+    while (!path.empty())
+    {
+        const auto end = path.find(separator);
+        auto name = unescape(path.substr(0, end));
+        const auto hash = std::hash<std::string_view>{}(name);
+        const auto index = to_index(name);
+        m_tokens.push_back(token{std::move(name), hash, index});
+
+        path.remove_prefix(end == std::string_view::npos ? path.size() : end + 1);
+    }
+
+    for (const auto& token : m_tokens)
+    {
+        m_key += m_key.empty() ? escape(token.name) : separator + escape(token.name);
+    }
+    m_keyHash = fnv1a_64(m_key);
+}
+
+const std::string& settings_path::str() const noexcept
+{
+    return m_path;
+}
+
+const char* settings_path::c_str() const noexcept
+{
+    return m_path.c_str();
+}
+
+const std::vector<settings_path::token>& settings_path::tokens() const noexcept
+{
+    return m_tokens;
+}
+
+const std::string& settings_path::key() const noexcept
+{
+    return m_key;
+}
+
+std::uint64_t settings_path::key_hash() const noexcept
+{
+    return m_keyHash;
+}
+
+settings_path settings_path::member(std::string_view name)
+{
+    return settings_path(escape(name));
+}
+
+std::string settings_path::escape(std::string_view name)
+{
+    std::string escaped;
+    escaped.reserve(name.size());
+    for (const auto c : name)
+    {
+        if (c == '~')
+        {
+            escaped += "~0";
+        }
+        else if (c == separator)
+        {
+            escaped += "~1";
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! Path of a setting in a hierarchical settings source, tokenized once at construction
+//! The syntax follows JSON Pointer: tokens are separated by '/', "~1" stands for '/' and "~0" for '~' within a token,
+//! a token of an array element is its index. The leading '/' is optional, i.e. "db/pool/size" equals "/db/pool/size".
+//!
+//! Prefer compiled_path<T>() for setting types, it tokenizes T::path only once. A path converted from a string
+//! literal on every call (e.g. reader.get(value, "name")) is tokenized, i.e. allocated, on every call.
+//! The getters took the name of a top-level member verbatim before the paths were introduced, such a name containing
+//! '/' or '~' has to be escaped now, or passed as settings_path::member.
+class settings_path final
+{
+public:
+    struct token final
+    {
+        static constexpr auto no_index = std::numeric_limits<std::size_t>::max();
+
+        //! unescaped name of the object member
+        std::string name;
+        //! std::hash<std::string_view> of the name, computed once
+        std::size_t hash;
+        //! the array index when the name is a number, no_index otherwise
+        std::size_t index;
+    };
+
+    static constexpr auto separator = '/';
+
+    // implicit on purpose, a string literal can be used wherever a path is expected
+    settings_path(const char* path);
+    settings_path(const std::string& path);
+    settings_path(std::string_view path);
+
+    //! \returns the path as it was passed to the constructor
+    const std::string& str() const noexcept;
+    const char* c_str() const noexcept;
+
+    const std::vector<token>& tokens() const noexcept;
+
+    //! \returns the normalized path, i.e. the escaped tokens joined by the separator without the leading one
+    //! Paths naming the same setting have the same key
+    const std::string& key() const noexcept;
+    //! fnv1a_64 of the key, stable across processes and platforms
+    std::uint64_t key_hash() const noexcept;
+
+    //! \returns the path of the top-level member named \p name verbatim, i.e. the '/' and '~' are not special
+    static settings_path member(std::string_view name);
+
+    //! Escapes the '~' and the separator in the \p name, i.e. the inverse of the tokenization
+    static std::string escape(std::string_view name);
+
+private:
+    std::string m_path;
+    std::vector<token> m_tokens;
+    std::string m_key;
+    std::uint64_t m_keyHash;
+};
+
+//! Tokenized path of the setting type \c T (i.e. T::path), created with the first call
+template <typename T>
+const settings_path& compiled_path()
+{
+    static const settings_path path{T::path};
+    return path;
+}
@@ -2,10 +2,32 @@
 
 #include "settings_provider.h"
 
-settings_provider::settings_provider(std::unique_ptr<settings_reader>&& settingsReader)
-    : m_settingsReader{ std::move(settingsReader) }
-    , m_observers{ callback_container_t::create_callback_container() }
+#include <stdexcept>
+
+settings_provider::settings_provider(std::unique_ptr<settings_reader>&& settingsReader, std::shared_ptr<bounded_executor> observerExecutor,
+                                     std::shared_ptr<settings_telemetry> telemetry)
+    : m_telemetry{ std::move(telemetry) }
+    , m_snapshot{ std::make_shared<const snapshot>(instrument(std::move(settingsReader)), 0) }
+    , m_observerExecutor{ std::move(observerExecutor) }
+    , m_observers{ callback_container_t::create_callback_container(m_observerExecutor) }
+{
+}
+
+settings_provider::generation_t settings_provider::reload(std::unique_ptr<settings_reader>&& settingsReader)
+{
+    auto reader = instrument(std::move(settingsReader));
+    const auto published = m_snapshot.update([&reader](const std::shared_ptr<const snapshot>& current) {
+        return std::make_shared<const snapshot>(std::move(reader), current->generation + 1);
+    });
+
+    notify_subscribers();
+
+    return published->generation;
+}
+
+settings_provider::generation_t settings_provider::generation() const
 {
+    return m_snapshot.load()->generation;
 }
 
 settings_provider::observer_token_t settings_provider::add_observer(observer_callback_t&& callback)
@@ -13,4 +35,40 @@ settings_provider::observer_token_t settings_provider::add_observer(observer_cal
     return m_observers->register_callback(std::move(callback));
 }
 
+void settings_provider::notify_subscribers()
+{
+    std::vector<std::function<void()>> notifications;
+    {
+        std::lock_guard<std::mutex> lock{ m_subscriptionsMtx };
+        // the currently published snapshot rather than the one of this reload, a concurrent reload may be newer
+        const auto current = m_snapshot.load();
+        for (auto& item : m_subscriptions)
+        {
+            if (auto notification = item.second->update(*current))
+            {
+                notifications.push_back(std::move(notification));
+            }
+        }
+    }
+
+    // outside of the lock, the subscribers may subscribe or reload
+    for (const auto& notification : notifications)
+    {
+        notification();
+    }
+}
+
+std::unique_ptr<const settings_reader> settings_provider::instrument(std::unique_ptr<settings_reader>&& settingsReader) const
+{
+    if (!settingsReader)
+    {
+        throw std::invalid_argument("settingsReader must not be null");
+    }
+
+    if (!m_telemetry)
+    {
+        return std::move(settingsReader);
+    }
 
+    return settings_telemetry::instrument(std::move(settingsReader), m_telemetry);
+}
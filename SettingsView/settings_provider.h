@@ -1,56 +1,284 @@
 #pragma once
 
 #include "callback_container.h"
+#include "lazy_settings_view.h"
+#include "rcu_ptr.h"
+#include "setting_descriptor.h"
 #include "settings_reader.h"
+#include "settings_snapshot.h"
+#include "settings_telemetry.h"
 #include "settings_view.h"
+#include "view_cache.h"
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class settings_provider
 {
 public:
-    using observer_callback_t = std::function<void(const std::string&, const std::vector<std::string>&)>;
+    //! Called with the consumer name and the descriptors of the requested setting types (in the order of get_view \c Args)
+    using observer_callback_t = std::function<void(const std::string&, setting_descriptors)>;
+    using generation_t = std::uint64_t;
+
+    //! Called with the new value of the setting type \c T
+    template <typename T>
+    using subscriber_callback_t = std::function<void(const typename T::value_type&)>;
+    template <typename T>
+    using subscription_token_t = typename callback_container<subscriber_callback_t<T>>::token_t;
 
 private:
     using callback_container_t = callback_container<observer_callback_t>;
     using observer_container_t = std::shared_ptr<callback_container_t>;
     using observer_token_t = typename callback_container_t::token_t;
 
+    //! Immutable state published to the readers, a new instance is created with each reload
+    using snapshot = settings_snapshot<settings_reader>;
+
+    //! Subscribers of a single setting type, see ::subscribe
+    class subscription_base
+    {
+    public:
+        virtual ~subscription_base() = default;
+
+        //! Compares the value in \p current with the last one
+        //! \returns the notification of the subscribers if the value changed, nullptr otherwise
+        virtual std::function<void()> update(const snapshot& current) = 0;
+    };
+
+    template <typename T>
+    class subscription;
+
+    //! The key is type_id_v of the setting type
+    using subscriptions_t = std::unordered_map<const void*, std::unique_ptr<subscription_base>>;
+
 public:
-    explicit settings_provider(std::unique_ptr<settings_reader>&& settingsReader);
+    //! The observers are notified synchronously by ::get_view unless the \p observerExecutor is passed,
+    //! ::get_view then only posts the notification to it (see callback_container)
+    //! The \p telemetry, when passed, records the ::get_view calls and the reads of the settings
+    explicit settings_provider(std::unique_ptr<settings_reader>&& settingsReader, std::shared_ptr<bounded_executor> observerExecutor = nullptr,
+                               std::shared_ptr<settings_telemetry> telemetry = nullptr);
 
+    //! Thread safe, never blocks on a concurrent ::reload
+    //! The returned view is built from a single snapshot, i.e. it never mixes values of two generations
+    //! The view is built only by the first call for the given \c Args of each generation, the following calls return its cheap copy
     template <typename... Args>
     settings_view<Args...> get_view(const std::string& consumerName);
 
+    //! As ::get_view, but each of the \c Args is parsed by the first lazy_settings_view::get of it
+    //! The lazy view is cached separately from the settings_view of the same \c Args, i.e. each setting of a generation
+    //! is parsed at most once by all the lazy views, regardless of the count of the consumers.
+    template <typename... Args>
+    lazy_settings_view<Args...> get_lazy_view(const std::string& consumerName);
+
+    //! As ::get_view, but a missing, mistyped or invalid (i.e. its \c parse threw) setting is returned rather than thrown,
+    //! e.g. to probe optional settings. The setting_error refers to the compiled_path of the failed setting type.
+    //! A failed view is not cached, i.e. each call reads the settings again (see settings_reader::try_get).
+    template <typename... Args>
+    setting_result<settings_view<Args...>> try_get_view(const std::string& consumerName);
+
+    //! Thread safe, replaces the settings for all subsequent ::get_view calls
+    //! The \p settingsReader has to be fully constructed (parsed) by the caller, the swap itself is cheap.
+    //! Callers of ::get_view that already hold the previous snapshot finish with the previous settings.
+    //! \returns generation of the published settings
+    generation_t reload(std::unique_ptr<settings_reader>&& settingsReader);
+
+    //! Generation of the currently published settings, starts with 0 and is incremented with each ::reload
+    generation_t generation() const;
+
     observer_token_t add_observer(observer_callback_t&& callback);
 
+    //! Thread safe, the \p callback is called with the new value of the setting type \c T when a ::reload changes it
+    //! The value is compared once per ::reload and setting type, regardless of the count of the subscribers.
+    //! A setting that cannot be read from the reloaded settings does not notify, it notifies when it is readable again.
+    //! The callbacks are called by ::reload (or posted to the observer executor), \c T::value_type must be equality comparable.
+    template <typename T>
+    subscription_token_t<T> subscribe(subscriber_callback_t<T>&& callback);
+
 private:
-    //! Helper method for reading value of type \c T from ::settings_reader
+    //! Notifies the observers of the \c Args request and returns the view returned by \p cached for the current snapshot
+    template <typename... Args, typename F>
+    auto observed_view(const std::string& consumerName, F&& cached);
+
+    //! Returns the cached view of \c Args or tries to read it, see settings_snapshot::view
+    template <typename... Args>
+    static setting_result<settings_view<Args...>> try_cached_view(const snapshot& current);
+
+    template <typename... Args, std::size_t... I>
+    static setting_result<settings_view<Args...>> try_read(const settings_reader& reader, std::index_sequence<I...>);
+
+    //! Parses the \p source of the setting type \c T to \p value
+    //! \returns false if the \c T::parse threw std::exception
     template <typename T>
-    T read(const char* path);
+    static bool try_parse(typename T::source_type& source, std::optional<typename T::value_type>& value);
 
-    std::unique_ptr<settings_reader> m_settingsReader;
+    //! Calls the subscribers of the settings changed by the last ::reload
+    void notify_subscribers();
+
+    //! \returns the \p settingsReader instrumented by ::m_telemetry if there is any
+    //! Throws std::invalid_argument when the \p settingsReader is null
+    std::unique_ptr<const settings_reader> instrument(std::unique_ptr<settings_reader>&& settingsReader) const;
+
+    std::shared_ptr<settings_telemetry> m_telemetry;
+    rcu_ptr<snapshot> m_snapshot;
+    std::shared_ptr<bounded_executor> m_observerExecutor;
     observer_container_t m_observers;
+
+    //! serializes the comparisons of the subscribed values
+    std::mutex m_subscriptionsMtx;
+    subscriptions_t m_subscriptions;
+};
+
+template <typename T>
+class settings_provider::subscription final : public subscription_base
+{
+public:
+    using value_t = typename T::value_type;
+    using callbacks_t = callback_container<subscriber_callback_t<T>>;
+
+    subscription(const snapshot& current, std::shared_ptr<bounded_executor> executor)
+        : m_value{read_value(current)}
+        , m_callbacks{callbacks_t::create_callback_container(std::move(executor))}
+    {
+    }
+
+    std::function<void()> update(const snapshot& current) override
+    {
+        auto value = read_value(current);
+        const auto changed = value && (!m_value || !(*value == *m_value));
+        m_value = std::move(value);
+        if (!changed)
+        {
+            return nullptr;
+        }
+
+        return [callbacks = m_callbacks, value = *m_value]() { (*callbacks)(value); };
+    }
+
+    typename callbacks_t::token_t add(subscriber_callback_t<T>&& callback)
+    {
+        return m_callbacks->register_callback(std::move(callback));
+    }
+
+private:
+    static std::optional<value_t> read_value(const snapshot& current)
+    {
+        // the view is cached, i.e. a following get_view<T> does not read it again
+        const auto view = try_cached_view<T>(current);
+        if (!view)
+        {
+            return std::nullopt;
+        }
+
+        return view->template get<T>();
+    }
+
+    std::optional<value_t> m_value;
+    std::shared_ptr<callbacks_t> m_callbacks;
 };
 
+template <typename T>
+settings_provider::subscription_token_t<T> settings_provider::subscribe(subscriber_callback_t<T>&& callback)
+{
+    std::lock_guard<std::mutex> lock{m_subscriptionsMtx};
+
+    auto& item = m_subscriptions[type_id_v<T>];
+    if (!item)
+    {
+        item = std::make_unique<subscription<T>>(*m_snapshot.load(), m_observerExecutor);
+    }
+
+    return static_cast<subscription<T>&>(*item).add(std::move(callback));
+}
+
 template <typename... Args>
 settings_view<Args...> settings_provider::get_view(const std::string& consumerName)
 {
-    // TODO typeid(Args).name() does not need to be human readable
-    const std::vector<std::string> types{typeid(Args).name()...};
-    (*m_observers)(consumerName, types);
+    return observed_view<Args...>(consumerName, [](const snapshot& current) { return current.view<Args...>(); });
+}
 
-    return settings_view<Args...>(Args::parse(read<typename Args::source_type>(Args::path))...);
+template <typename... Args>
+lazy_settings_view<Args...> settings_provider::get_lazy_view(const std::string& consumerName)
+{
+    return observed_view<Args...>(consumerName, [](const snapshot& current) { return current.lazy_view<Args...>(); });
 }
 
-template <typename T>
-T settings_provider::read(const char* path)
+template <typename... Args>
+setting_result<settings_view<Args...>> settings_provider::try_get_view(const std::string& consumerName)
 {
-    T value{};
-    m_settingsReader->get(value, path);
+    return observed_view<Args...>(consumerName, [](const snapshot& current) { return try_cached_view<Args...>(current); });
+}
 
-    return value;
+template <typename... Args, typename F>
+auto settings_provider::observed_view(const std::string& consumerName, F&& cached)
+{
+    const auto started = m_telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    // the descriptors are static, the notification does not allocate
+    constexpr auto descriptors = setting_descriptors_of<Args...>();
+    (*m_observers)(consumerName, descriptors);
+
+    // keeps the snapshot alive even when a reload is published in the meantime
+    const auto current = m_snapshot.load();
+    auto view = cached(*current);
+
+    if (m_telemetry)
+    {
+        m_telemetry->record_view(consumerName, descriptors, std::chrono::steady_clock::now() - started);
+    }
+
+    return view;
+}
+
+template <typename... Args>
+setting_result<settings_view<Args...>> settings_provider::try_cached_view(const snapshot& current)
+{
+    return current.views.try_get<settings_view<Args...>>(
+        [&current]() { return try_read<Args...>(*current.reader, std::index_sequence_for<Args...>{}); });
+}
+
+template <typename... Args, std::size_t... I>
+setting_result<settings_view<Args...>> settings_provider::try_read(const settings_reader& reader, std::index_sequence<I...>)
+{
+    std::tuple<typename Args::source_type...> sources;
+    const std::array<setting_request, sizeof...(Args)> requests{{{&compiled_path<Args>(), &std::get<I>(sources)}...}};
+    const auto read = reader.try_get(requests.data(), requests.size());
+    if (!read)
+    {
+        return read.error();
+    }
+
+    std::tuple<std::optional<typename Args::value_type>...> values;
+    // stops at the first invalid setting as the reader stops at the first failed one
+    auto invalid = requests.size();
+    ((try_parse<Args>(std::get<I>(sources), std::get<I>(values)) || (invalid = I, false)) && ...);
+    if (invalid != requests.size())
+    {
+        return setting_error{setting_errc::invalid, requests[invalid].path};
+    }
+
+    return settings_view<Args...>(std::move(*std::get<I>(values))...);
+}
+
+template <typename T>
+bool settings_provider::try_parse(typename T::source_type& source, std::optional<typename T::value_type>& value)
+{
+    try
+    {
+        value.emplace(T::parse(std::move(source)));
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
 }
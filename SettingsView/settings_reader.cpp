@@ -0,0 +1,329 @@
+#include "pch.h"
+
+#include "settings_reader.h"
+
+#include <stdexcept>
+
+const char* setting_type_name(const int*) noexcept
+{
+    return "int";
+}
+
+const char* setting_type_name(const std::string*) noexcept
+{
+    return "string";
+}
+
+const char* setting_type_name(const std::string_view*) noexcept
+{
+    return "string";
+}
+
+const char* setting_type_name(const std::int64_t*) noexcept
+{
+    return "int64";
+}
+
+const char* setting_type_name(const double*) noexcept
+{
+    return "double";
+}
+
+const char* setting_type_name(const bool*) noexcept
+{
+    return "bool";
+}
+
+const char* setting_type_name(const numeric_array<double>*) noexcept
+{
+    return "double array";
+}
+
+const char* setting_type_name(const numeric_array<std::int64_t>*) noexcept
+{
+    return "int64 array";
+}
+
+const char* setting_errc_text(setting_errc code) noexcept
+{
+    switch (code)
+    {
+    case setting_errc::not_found:
+        return "not found";
+    case setting_errc::type_mismatch:
+        return "is not of the requested type";
+    case setting_errc::unreadable:
+        return "cannot be read";
+    case setting_errc::invalid:
+        return "is invalid";
+    }
+
+    return "unknown error";
+}
+
+std::string setting_error::message() const
+{
+    return "Member '" + path->str() + "' " + setting_errc_text(code);
+}
+
+setting_result<void>::setting_result(const setting_error& error) noexcept
+    : m_error{error}
+{
+}
+
+bool setting_result<void>::has_value() const noexcept
+{
+    return !m_error;
+}
+
+setting_result<void>::operator bool() const noexcept
+{
+    return has_value();
+}
+
+void setting_result<void>::value() const
+{
+    if (m_error)
+    {
+        throw std::runtime_error(m_error->message());
+    }
+}
+
+const setting_error& setting_result<void>::error() const noexcept
+{
+    return *m_error;
+}
+
+bool convert_setting(const setting_value& setting, int& value)
+{
+    const auto integer = std::get_if<int>(&setting);
+    if (integer == nullptr)
+    {
+        return false;
+    }
+
+    value = *integer;
+    return true;
+}
+
+bool convert_setting(const setting_value& setting, std::string& value)
+{
+    const auto string = std::get_if<std::string_view>(&setting);
+    if (string == nullptr)
+    {
+        return false;
+    }
+
+    value = std::string(*string);
+    return true;
+}
+
+bool convert_setting(const setting_value& setting, std::string_view& value)
+{
+    const auto string = std::get_if<std::string_view>(&setting);
+    if (string == nullptr)
+    {
+        return false;
+    }
+
+    value = *string;
+    return true;
+}
+
+bool convert_setting(const setting_value& setting, std::int64_t& value)
+{
+    if (const auto integer = std::get_if<int>(&setting))
+    {
+        value = *integer;
+        return true;
+    }
+
+    const auto integer64 = std::get_if<std::int64_t>(&setting);
+    if (integer64 == nullptr)
+    {
+        return false;
+    }
+
+    value = *integer64;
+    return true;
+}
+
+bool convert_setting(const setting_value& setting, double& value)
+{
+    if (const auto integer = std::get_if<int>(&setting))
+    {
+        value = *integer;
+        return true;
+    }
+
+    if (const auto integer64 = std::get_if<std::int64_t>(&setting))
+    {
+        value = static_cast<double>(*integer64);
+        return true;
+    }
+
+    const auto real = std::get_if<double>(&setting);
+    if (real == nullptr)
+    {
+        return false;
+    }
+
+    value = *real;
+    return true;
+}
+
+bool convert_setting(const setting_value& setting, bool& value)
+{
+    const auto boolean = std::get_if<bool>(&setting);
+    if (boolean == nullptr)
+    {
+        return false;
+    }
+
+    value = *boolean;
+    return true;
+}
+
+bool convert_setting(const setting_value&, numeric_array<double>&)
+{
+    return false;
+}
+
+bool convert_setting(const setting_value&, numeric_array<std::int64_t>&)
+{
+    return false;
+}
+
+void settings_errors::not_found(const settings_path& path)
+{
+    m_errors += m_errors.empty() ? "Member '" : "\nMember '";
+    m_errors += path.str();
+    m_errors += "' not found";
+}
+
+void settings_errors::type_mismatch(const settings_path& path, const char* typeName)
+{
+    m_errors += m_errors.empty() ? "Member '" : "\nMember '";
+    m_errors += path.str();
+    m_errors += "' is not of type ";
+    m_errors += typeName;
+}
+
+void settings_errors::add(const char* message)
+{
+    m_errors += m_errors.empty() ? "" : "\n";
+    m_errors += message;
+}
+
+void settings_errors::add(const setting_request& request, setting_errc code)
+{
+    switch (code)
+    {
+    case setting_errc::not_found:
+        not_found(*request.path);
+        break;
+    case setting_errc::type_mismatch:
+        std::visit([this, &request](auto destination) { type_mismatch(*request.path, setting_type_name(destination)); }, request.destination);
+        break;
+    default:
+        add(setting_error{code, request.path}.message().c_str());
+        break;
+    }
+}
+
+void settings_errors::throw_if_any() const
+{
+    if (!m_errors.empty())
+    {
+        throw std::runtime_error(m_errors);
+    }
+}
+
+namespace
+{
+    template <typename T>
+    [[noreturn]] void throw_type_mismatch(const T* value, const settings_path& path)
+    {
+        throw std::runtime_error("Member '" + path.str() + "' is not of type " + setting_type_name(value));
+    }
+}  // namespace
+
+void settings_reader::get(std::int64_t& value, const settings_path& path) const
+{
+    throw_type_mismatch(&value, path);
+}
+
+void settings_reader::get(double& value, const settings_path& path) const
+{
+    throw_type_mismatch(&value, path);
+}
+
+void settings_reader::get(bool& value, const settings_path& path) const
+{
+    throw_type_mismatch(&value, path);
+}
+
+void settings_reader::get(numeric_array<double>& value, const settings_path& path) const
+{
+    throw_type_mismatch(&value, path);
+}
+
+void settings_reader::get(numeric_array<std::int64_t>& value, const settings_path& path) const
+{
+    throw_type_mismatch(&value, path);
+}
+
+void settings_reader::get(const setting_request* requests, std::size_t count) const
+{
+    settings_errors errors;
+    for (auto request = requests; request != requests + count; ++request)
+    {
+        try
+        {
+            std::visit([this, request](auto destination) { get(*destination, *request->path); }, request->destination);
+        }
+        catch (const std::runtime_error& ex)
+        {
+            errors.add(ex.what());
+        }
+    }
+
+    errors.throw_if_any();
+}
+
+setting_result<void> settings_reader::try_get(const setting_request* requests, std::size_t count) const
+{
+    for (auto request = requests; request != requests + count; ++request)
+    {
+        if (const auto code = read(*request))
+        {
+            return setting_error{*code, request->path};
+        }
+    }
+
+    return {};
+}
+
+std::optional<setting_errc> settings_reader::read(const setting_request& request) const
+{
+    // one by one, the message of the batch would not tell which of the requests failed
+    try
+    {
+        get(&request, 1);
+    }
+    catch (const std::runtime_error&)
+    {
+        return setting_errc::unreadable;
+    }
+
+    return std::nullopt;
+}
+
+void settings_reader::for_each(const visitor_t&) const
+{
+    throw std::logic_error("The settings reader cannot enumerate its settings");
+}
+
+void settings_reader::for_each_array(const array_visitor_t&) const
+{
+}
@@ -1,15 +1,284 @@
 #pragma once
 
+#include "numeric_array.h"
+#include "settings_path.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+//! Single item of the batch settings_reader::get
+struct setting_request
+{
+    const settings_path* path;
+    //! the value is written here when the \c path is found and has the matching type
+    std::variant<int*, std::string*, std::string_view*, std::int64_t*, double*, bool*, numeric_array<double>*, numeric_array<std::int64_t>*>
+        destination;
+};
+
+//! Value of a single setting enumerated by settings_reader::for_each
+//! The string points to the storage of the reader, i.e. it is valid as long as the reader exists
+//! The int64 alternative holds only the integers not fitting to int, the arrays are not enumerated.
+using setting_value = std::variant<int, std::string_view, std::int64_t, double, bool>;
+
+//! Converts the \p setting to \p value, for the readers keeping their settings as setting_value
+//! \returns false if the \p setting is not of the requested type
+//! The integers convert to the wider integer and to double, never the other way round.
+bool convert_setting(const setting_value& setting, int& value);
+bool convert_setting(const setting_value& setting, std::string& value);
+bool convert_setting(const setting_value& setting, std::string_view& value);
+bool convert_setting(const setting_value& setting, std::int64_t& value);
+bool convert_setting(const setting_value& setting, double& value);
+bool convert_setting(const setting_value& setting, bool& value);
+//! Always false, setting_value holds no arrays
+bool convert_setting(const setting_value& setting, numeric_array<double>& value);
+bool convert_setting(const setting_value& setting, numeric_array<std::int64_t>& value);
+
+//! \returns the name of the setting type used in the error messages
+const char* setting_type_name(const int*) noexcept;
+const char* setting_type_name(const std::string*) noexcept;
+const char* setting_type_name(const std::string_view*) noexcept;
+const char* setting_type_name(const std::int64_t*) noexcept;
+const char* setting_type_name(const double*) noexcept;
+const char* setting_type_name(const bool*) noexcept;
+const char* setting_type_name(const numeric_array<double>*) noexcept;
+const char* setting_type_name(const numeric_array<std::int64_t>*) noexcept;
+
+//! Failure code of the non-throwing settings_reader::try_get
+enum class setting_errc : std::uint8_t
+{
+    not_found,
+    type_mismatch,
+    //! the reader threw an error of other kind (see the default settings_reader::read) or the stored value is corrupt
+    unreadable,
+    //! the setting was read, but its parse threw, see settings_provider::try_get_view
+    invalid
+};
+
+//! \returns the description used in the error messages, e.g. "not found"
+const char* setting_errc_text(setting_errc code) noexcept;
+
+//! Failure of a non-throwing read, no message is built until it is asked for
+struct setting_error
+{
+    setting_errc code;
+    //! the path of the failed request (e.g. compiled_path of the setting type), it is referred rather than copied
+    const settings_path* path;
+
+    //! \returns "Member '<path>' <setting_errc_text>"
+    std::string message() const;
+};
+
+//! Either a value of \c T or the setting_error preventing it, as std::expected does
+template <typename T>
+class setting_result final
+{
+public:
+    setting_result(T&& value);
+    setting_result(const setting_error& error) noexcept;
+
+    bool has_value() const noexcept;
+    explicit operator bool() const noexcept;
+
+    //! Throws std::runtime_error with the setting_error::message when there is no value
+    const T& value() const&;
+    T&& value() &&;
 
+    //! Must not be called when there is no value
+    const T& operator*() const& noexcept;
+    const T* operator->() const noexcept;
+
+    //! Must not be called when there is a value
+    const setting_error& error() const noexcept;
+
+private:
+    std::variant<T, setting_error> m_result;
+};
+
+//! Success or the setting_error, the result of the reads writing their values to the requests
+template <>
+class setting_result<void> final
+{
+public:
+    setting_result() noexcept = default;
+    setting_result(const setting_error& error) noexcept;
+
+    bool has_value() const noexcept;
+    explicit operator bool() const noexcept;
+
+    //! Throws std::runtime_error with the setting_error::message on failure
+    void value() const;
+
+    //! Must not be called on success
+    const setting_error& error() const noexcept;
+
+private:
+    std::optional<setting_error> m_error;
+};
+
+//! Collects the errors of a batch settings_reader::get, so the caller can fix all of them in one go
+class settings_errors final
+{
+public:
+    //! Adds "Member '<path>' not found"
+    void not_found(const settings_path& path);
+    //! Adds "Member '<path>' is not of type <typeName>"
+    void type_mismatch(const settings_path& path, const char* typeName);
+    //! Adds the \p message as it is
+    void add(const char* message);
+    //! Adds the error of the failed \p request as ::not_found or ::type_mismatch do
+    void add(const setting_request& request, setting_errc code);
+
+    //! Throws std::runtime_error with all the errors, one per line, if there is any
+    void throw_if_any() const;
+
+private:
+    std::string m_errors;
+};
+
+// The getters must be thread safe, the same instance is shared by all readers of a settings_provider snapshot
+// The paths may be hierarchical (see settings_path), a string literal converts to settings_path implicitly
+// A literal is a JSON Pointer tokenized by every call, keep the settings_path (e.g. compiled_path) of the settings read
+// repeatedly and use settings_path::member for a top-level name containing '/' or '~'.
 class settings_reader
 {
 public:
     virtual ~settings_reader() = default;
 
-    virtual void get(int& value, const std::string& path) = 0;
-    virtual void get(int& value, const char* path) = 0;
+    virtual void get(int& value, const settings_path& path) const = 0;
+
+    virtual void get(std::string& value, const settings_path& path) const = 0;
+    //! The \p value points to the storage of the reader, i.e. it is valid as long as the reader exists
+    virtual void get(std::string_view& value, const settings_path& path) const = 0;
 
-    virtual void get(std::string& value, const std::string& path) = 0;
-    virtual void get(std::string& value, const char* path) = 0;
-};
\ No newline at end of file
+    // The default implementations of the following getters throw the type mismatch error,
+    // i.e. a reader not overriding them behaves as if none of its settings is of that type
+
+    //! Reads the integers fitting to int as well
+    virtual void get(std::int64_t& value, const settings_path& path) const;
+    //! Reads the integers as well
+    virtual void get(double& value, const settings_path& path) const;
+    virtual void get(bool& value, const settings_path& path) const;
+
+    // The arrays are read by json_settings_reader, binary_settings_reader, streaming_json_settings_reader (the registered
+    // arrays only) and layered_settings_reader (from the layer of the winning array)
+
+    //! Reads the whole array of numbers (integers included) at once
+    virtual void get(numeric_array<double>& value, const settings_path& path) const;
+    //! Reads the whole array of integers at once
+    virtual void get(numeric_array<std::int64_t>& value, const settings_path& path) const;
+
+    //! Reads all the \p count \p requests in one call
+    //! Throws a single std::runtime_error describing every missing or mistyped path (one per line)
+    //! The default implementation calls the single value getters, override it when the backend can do better.
+    virtual void get(const setting_request* requests, std::size_t count) const;
+
+    //! As the batch ::get, but a missing or mistyped path is returned rather than thrown, e.g. to probe optional settings
+    //! Stops at the first failed request, the destinations of the following requests are left untouched.
+    //! No error message is built, only std::bad_alloc may be thrown (e.g. by copying a string value).
+    //! The default implementation calls ::read request by request.
+    virtual setting_result<void> try_get(const setting_request* requests, std::size_t count) const;
+
+    //! Single value ::try_get, \c T is any of the setting_request destination types
+    template <typename T>
+    setting_result<void> try_get(T& value, const settings_path& path) const;
+
+    using visitor_t = std::function<void(std::string_view key, const setting_value& value)>;
+
+    //! Calls the \p visitor with the key (see settings_path::key) and the value of each setting readable by the getters
+    //! The default implementation throws std::logic_error, override it when the backend can enumerate its settings
+    //! (e.g. to be a layer of layered_settings_reader).
+    virtual void for_each(const visitor_t& visitor) const;
+
+    using array_visitor_t = std::function<void(std::string_view key)>;
+
+    //! Calls the \p visitor with the key of each array, its items are enumerated by ::for_each one by one
+    //! (the key of an item extends the key of the array by its index). It lets layered_settings_reader merge an array
+    //! as a single value. The default implementation reports none, i.e. the items of such a reader are merged one by one.
+    virtual void for_each_array(const array_visitor_t& visitor) const;
+
+protected:
+    //! Reads the single \p request, the non-throwing hook of the default ::try_get
+    //! \returns the code of the failure or std::nullopt when the value was written
+    //! The default implementation is a slow fallback: it calls the batch ::get and catches its exception, i.e. it builds
+    //! the error message and reports any failure as setting_errc::unreadable. Override it to tell setting_errc::not_found
+    //! from setting_errc::type_mismatch and to fail without throwing.
+    virtual std::optional<setting_errc> read(const setting_request& request) const;
+};
+
+template <typename T>
+setting_result<T>::setting_result(T&& value)
+    : m_result{std::in_place_index<0>, std::move(value)}
+{
+}
+
+template <typename T>
+setting_result<T>::setting_result(const setting_error& error) noexcept
+    : m_result{std::in_place_index<1>, error}
+{
+}
+
+template <typename T>
+bool setting_result<T>::has_value() const noexcept
+{
+    return m_result.index() == 0;
+}
+
+template <typename T>
+setting_result<T>::operator bool() const noexcept
+{
+    return has_value();
+}
+
+template <typename T>
+const T& setting_result<T>::value() const&
+{
+    if (!has_value())
+    {
+        throw std::runtime_error(error().message());
+    }
+
+    return **this;
+}
+
+template <typename T>
+T&& setting_result<T>::value() &&
+{
+    if (!has_value())
+    {
+        throw std::runtime_error(error().message());
+    }
+
+    return std::move(*std::get_if<0>(&m_result));
+}
+
+template <typename T>
+const T& setting_result<T>::operator*() const& noexcept
+{
+    return *std::get_if<0>(&m_result);
+}
+
+template <typename T>
+const T* setting_result<T>::operator->() const noexcept
+{
+    return std::get_if<0>(&m_result);
+}
+
+template <typename T>
+const setting_error& setting_result<T>::error() const noexcept
+{
+    return *std::get_if<1>(&m_result);
+}
+
+template <typename T>
+setting_result<void> settings_reader::try_get(T& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    return try_get(&request, 1);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "lazy_settings_view.h"
+#include "settings_path.h"
+#include "settings_reader.h"
+#include "settings_view.h"
+#include "view_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//! Immutable state published to the readers by settings_provider and static_settings_provider, a new instance
+//! is created with each reload. The views are read through \c Reader, i.e. the only code that differs between
+//! the providers is the reader call: virtual for settings_reader, a non-virtual qualified call for a concrete reader.
+template <typename Reader>
+struct settings_snapshot final
+{
+    using generation_t = std::uint64_t;
+
+    settings_snapshot(std::unique_ptr<const Reader>&& settingsReader, generation_t settingsGeneration);
+
+    //! \returns the cached view of \c Args or reads it, caches it and returns it
+    //! A view that failed to be read is not cached, the next call will throw again
+    template <typename... Args>
+    settings_view<Args...> view() const;
+
+    //! As ::view, but each of the \c Args is parsed by the first lazy_settings_view::get of it
+    template <typename... Args>
+    lazy_settings_view<Args...> lazy_view() const;
+
+    std::unique_ptr<const Reader> reader;
+    generation_t generation;
+    //! The only mutable part, the views are built lazily and dropped together with the snapshot on reload
+    view_cache views;
+
+private:
+    //! Helper method reading the sources of all the \c Args from the ::reader in a single batch
+    template <typename... Args, std::size_t... I>
+    void read_sources(std::tuple<typename Args::source_type...>& sources, std::index_sequence<I...>) const;
+
+    template <typename... Args, std::size_t... I>
+    settings_view<Args...> read(std::index_sequence<I...>) const;
+
+    template <typename... Args, std::size_t... I>
+    lazy_settings_view<Args...> read_lazy(std::index_sequence<I...>) const;
+};
+
+template <typename Reader>
+settings_snapshot<Reader>::settings_snapshot(std::unique_ptr<const Reader>&& settingsReader, generation_t settingsGeneration)
+    : reader{std::move(settingsReader)}
+    , generation{settingsGeneration}
+{
+}
+
+template <typename Reader>
+template <typename... Args>
+settings_view<Args...> settings_snapshot<Reader>::view() const
+{
+    return views.template get<settings_view<Args...>>([this]() { return read<Args...>(std::index_sequence_for<Args...>{}); });
+}
+
+template <typename Reader>
+template <typename... Args>
+lazy_settings_view<Args...> settings_snapshot<Reader>::lazy_view() const
+{
+    return views.template get<lazy_settings_view<Args...>>([this]() { return read_lazy<Args...>(std::index_sequence_for<Args...>{}); });
+}
+
+template <typename Reader>
+template <typename... Args, std::size_t... I>
+void settings_snapshot<Reader>::read_sources(std::tuple<typename Args::source_type...>& sources, std::index_sequence<I...>) const
+{
+    const std::array<setting_request, sizeof...(Args)> requests{{{&compiled_path<Args>(), &std::get<I>(sources)}...}};
+    if constexpr (std::is_same_v<Reader, settings_reader>)
+    {
+        reader->get(requests.data(), requests.size());
+    }
+    else
+    {
+        // the qualified call is not virtual even if the Reader is not final
+        reader->Reader::get(requests.data(), requests.size());
+    }
+}
+
+template <typename Reader>
+template <typename... Args, std::size_t... I>
+settings_view<Args...> settings_snapshot<Reader>::read(std::index_sequence<I...> indices) const
+{
+    std::tuple<typename Args::source_type...> sources;
+    read_sources<Args...>(sources, indices);
+
+    return settings_view<Args...>(Args::parse(std::move(std::get<I>(sources)))...);
+}
+
+template <typename Reader>
+template <typename... Args, std::size_t... I>
+lazy_settings_view<Args...> settings_snapshot<Reader>::read_lazy(std::index_sequence<I...> indices) const
+{
+    std::tuple<typename Args::source_type...> sources;
+    read_sources<Args...>(sources, indices);
+
+    return lazy_settings_view<Args...>(std::move(std::get<I>(sources))...);
+}
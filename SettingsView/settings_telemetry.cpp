@@ -0,0 +1,529 @@
+#include "pch.h"
+
+#include "settings_telemetry.h"
+
+#include <algorithm>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    std::uint64_t to_nanoseconds(std::chrono::nanoseconds duration) noexcept
+    {
+        return static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+    }
+
+    //! Count of the views requested by a consumer
+    struct view_counter final
+    {
+        //! Published last (release), the other members do not change once it is set
+        std::atomic<const setting_descriptor*> descriptors{nullptr};
+        std::size_t descriptorsCount{0};
+        std::uint32_t consumer{0};
+        //! Written by the owning thread only, i.e. incremented without a read-modify-write
+        std::atomic<std::uint64_t> count{0};
+    };
+
+    //! Open addressing table (linear probing) of the view_counter of a thread, the key is the descriptors address and the consumer
+    struct view_table final
+    {
+        explicit view_table(std::size_t capacity)
+            : mask{capacity - 1}
+            , used{0}
+            , counters{std::make_unique<view_counter[]>(capacity)}
+        {
+        }
+
+        std::size_t mask;
+        //! accessed by the owning thread only
+        std::size_t used;
+        std::unique_ptr<view_counter[]> counters;
+    };
+
+    constexpr std::size_t initial_view_table_capacity = 64;
+
+    std::size_t view_hash(const setting_descriptor* descriptors, std::uint32_t consumer) noexcept
+    {
+        // the descriptors are pointer aligned, i.e. the low bits of their addresses are zeros
+        return (reinterpret_cast<std::uintptr_t>(descriptors) >> 4) ^ (std::size_t{consumer} * 0x9e3779b9u);
+    }
+
+    //! \returns the free counter of the \p table the key belongs to, the table must not be full
+    view_counter& free_counter(view_table& table, const setting_descriptor* descriptors, std::uint32_t consumer) noexcept
+    {
+        auto index = view_hash(descriptors, consumer) & table.mask;
+        while (table.counters[index].descriptors.load(std::memory_order_relaxed) != nullptr)
+        {
+            index = (index + 1) & table.mask;
+        }
+
+        return table.counters[index];
+    }
+
+    //! Called by the owning thread only
+    void publish(view_counter& counter, const setting_descriptor* descriptors, std::size_t descriptorsCount, std::uint32_t consumer,
+                 std::uint64_t count) noexcept
+    {
+        counter.descriptorsCount = descriptorsCount;
+        counter.consumer = consumer;
+        counter.count.store(count, std::memory_order_relaxed);
+        counter.descriptors.store(descriptors, std::memory_order_release);
+    }
+
+    //! Records the duration of the getters of the wrapped reader
+    class instrumented_settings_reader final : public settings_reader
+    {
+    public:
+        instrumented_settings_reader(std::unique_ptr<const settings_reader>&& reader, std::shared_ptr<settings_telemetry> telemetry)
+            : m_reader{std::move(reader)}
+            , m_telemetry{std::move(telemetry)}
+        {
+        }
+
+        void get(int& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(std::string& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(std::string_view& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(std::int64_t& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(double& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(bool& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(numeric_array<double>& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(numeric_array<std::int64_t>& value, const settings_path& path) const override
+        {
+            timed([&]() { m_reader->get(value, path); });
+        }
+
+        void get(const setting_request* requests, std::size_t count) const override
+        {
+            timed([&]() { m_reader->get(requests, count); });
+        }
+
+        setting_result<void> try_get(const setting_request* requests, std::size_t count) const override
+        {
+            const auto started = std::chrono::steady_clock::now();
+            auto result = m_reader->try_get(requests, count);
+            if (result)
+            {
+                m_telemetry->record_read(std::chrono::steady_clock::now() - started);
+            }
+
+            return result;
+        }
+
+        void for_each(const visitor_t& visitor) const override
+        {
+            m_reader->for_each(visitor);
+        }
+
+        void for_each_array(const array_visitor_t& visitor) const override
+        {
+            m_reader->for_each_array(visitor);
+        }
+
+    private:
+        //! The failed reads are not recorded
+        template <typename F>
+        void timed(F&& f) const
+        {
+            const auto started = std::chrono::steady_clock::now();
+            f();
+            m_telemetry->record_read(std::chrono::steady_clock::now() - started);
+        }
+
+        std::unique_ptr<const settings_reader> m_reader;
+        std::shared_ptr<settings_telemetry> m_telemetry;
+    };
+
+    void append_json_string(std::string& out, std::string_view value)
+    {
+        constexpr auto hexDigits = "0123456789abcdef";
+
+        out += '"';
+        for (const auto c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out += "\\u00";
+                    out += hexDigits[(c >> 4) & 0xf];
+                    out += hexDigits[c & 0xf];
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    void append_json_summary(std::string& out, const latency_summary& summary)
+    {
+        out += "{\"count\": " + std::to_string(summary.count);
+        out += ", \"p50\": " + std::to_string(summary.p50);
+        out += ", \"p90\": " + std::to_string(summary.p90);
+        out += ", \"p99\": " + std::to_string(summary.p99);
+        out += ", \"max\": " + std::to_string(summary.max) + "}";
+    }
+
+    void append_text_summary(std::string& out, const char* name, const latency_summary& summary)
+    {
+        out += name;
+        out += " latency [ns]: count " + std::to_string(summary.count);
+        out += ", p50 " + std::to_string(summary.p50);
+        out += ", p90 " + std::to_string(summary.p90);
+        out += ", p99 " + std::to_string(summary.p99);
+        out += ", max " + std::to_string(summary.max) + "\n";
+    }
+}  // namespace
+
+void latency_histogram::record(std::uint64_t value) noexcept
+{
+    m_counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void latency_histogram::add_to(counts_t& counts) const noexcept
+{
+    for (std::size_t i = 0; i < buckets_count; ++i)
+    {
+        counts[i] += m_counts[i].load(std::memory_order_relaxed);
+    }
+}
+
+std::size_t latency_histogram::bucket_index(std::uint64_t value) noexcept
+{
+    value = std::min(value, max_value);
+    if (value < sub_buckets_count)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    std::size_t highestBit = 0;
+    for (std::size_t step = 32; step != 0; step /= 2)
+    {
+        if ((value >> (highestBit + step)) != 0)
+        {
+            highestBit += step;
+        }
+    }
+
+    // the sub_bucket_bits below the highest bit select the linear sub-bucket
+    const auto shift = highestBit - sub_bucket_bits;
+    return (shift + 1) * sub_buckets_count + static_cast<std::size_t>((value >> shift) - sub_buckets_count);
+}
+
+std::uint64_t latency_histogram::bucket_max(std::size_t index) noexcept
+{
+    if (index < sub_buckets_count)
+    {
+        return index;
+    }
+
+    const auto shift = index / sub_buckets_count - 1;
+    const std::uint64_t subBucket = sub_buckets_count + index % sub_buckets_count;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+latency_summary latency_summary::from_counts(const latency_histogram::counts_t& counts) noexcept
+{
+    latency_summary summary{};
+    for (const auto count : counts)
+    {
+        summary.count += count;
+    }
+
+    // the lowest bucket holding at least the given count of the values
+    auto percentile = [&counts, &summary](std::uint64_t percent) {
+        const auto rank = std::max<std::uint64_t>((summary.count * percent + 99) / 100, 1);
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i)
+        {
+            cumulative += counts[i];
+            if (cumulative >= rank)
+            {
+                return latency_histogram::bucket_max(i);
+            }
+        }
+        return std::uint64_t{0};
+    };
+
+    if (summary.count != 0)
+    {
+        summary.p50 = percentile(50);
+        summary.p90 = percentile(90);
+        summary.p99 = percentile(99);
+        summary.max = percentile(100);
+    }
+
+    return summary;
+}
+
+std::string telemetry_report::to_text() const
+{
+    std::string out;
+    append_text_summary(out, "get_view", viewLatency);
+    append_text_summary(out, "settings_reader::get", readLatency);
+    for (const auto& item : accesses)
+    {
+        out += "consumer '" + item.consumer + "' read '" + item.path + "': " + std::to_string(item.count) + "\n";
+    }
+
+    return out;
+}
+
+std::string telemetry_report::to_json() const
+{
+    std::string out{"{\"view_latency\": "};
+    append_json_summary(out, viewLatency);
+    out += ", \"read_latency\": ";
+    append_json_summary(out, readLatency);
+    out += ", \"accesses\": [";
+    for (std::size_t i = 0; i < accesses.size(); ++i)
+    {
+        out += i == 0 ? "{\"consumer\": " : ", {\"consumer\": ";
+        append_json_string(out, accesses[i].consumer);
+        out += ", \"path\": ";
+        append_json_string(out, accesses[i].path);
+        out += ", \"count\": " + std::to_string(accesses[i].count) + "}";
+    }
+    out += "]}";
+
+    return out;
+}
+
+struct alignas(64) settings_telemetry::thread_counters final
+{
+    thread_counters()
+        : views{nullptr}
+        , next{nullptr}
+    {
+        tables.push_back(std::make_unique<view_table>(initial_view_table_capacity));
+        views.store(tables.back().get(), std::memory_order_relaxed);
+    }
+
+    latency_histogram viewLatency;
+    latency_histogram readLatency;
+    //! The current table, replaced by a twice as large one when it is half full
+    std::atomic<view_table*> views;
+    //! All the tables ever used, ::report may still be reading the replaced ones
+    std::vector<std::unique_ptr<view_table>> tables;
+    //! The names and the ids of the consumers seen by the thread, i.e. a subset of m_consumerIds read without the lock
+    std::unordered_map<std::string, std::uint32_t> consumerIds;
+    //! Set before the counters are published to m_threads
+    thread_counters* next;
+};
+
+settings_telemetry::settings_telemetry()
+    : m_id{[]() {
+        static std::atomic<std::uint64_t> nextId{0};
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }()}
+    , m_threads{nullptr}
+{
+}
+
+settings_telemetry::~settings_telemetry()
+{
+    auto* counters = m_threads.load(std::memory_order_acquire);
+    while (counters != nullptr)
+    {
+        delete std::exchange(counters, counters->next);
+    }
+}
+
+void settings_telemetry::record_view(const std::string& consumer, setting_descriptors descriptors, std::chrono::nanoseconds duration)
+{
+    auto& local = local_counters();
+    local.viewLatency.record(to_nanoseconds(duration));
+
+    // a view without any setting does not access anything
+    if (descriptors.size() == 0)
+    {
+        return;
+    }
+
+    const auto consumerId = consumer_id(local, consumer);
+    auto* table = local.views.load(std::memory_order_relaxed);
+    for (auto index = view_hash(descriptors.begin(), consumerId) & table->mask;; index = (index + 1) & table->mask)
+    {
+        auto& counter = table->counters[index];
+        const auto* key = counter.descriptors.load(std::memory_order_relaxed);
+        if (key == nullptr)
+        {
+            break;
+        }
+
+        if (key == descriptors.begin() && counter.consumer == consumerId)
+        {
+            counter.count.store(counter.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if ((table->used + 1) * 2 > table->mask + 1)
+    {
+        auto grown = std::make_unique<view_table>((table->mask + 1) * 2);
+        for (std::size_t i = 0; i <= table->mask; ++i)
+        {
+            const auto& counter = table->counters[i];
+            const auto* key = counter.descriptors.load(std::memory_order_relaxed);
+            if (key != nullptr)
+            {
+                publish(free_counter(*grown, key, counter.consumer), key, counter.descriptorsCount, counter.consumer,
+                        counter.count.load(std::memory_order_relaxed));
+            }
+        }
+
+        grown->used = table->used;
+        table = grown.get();
+        local.tables.push_back(std::move(grown));
+        local.views.store(table, std::memory_order_release);
+    }
+
+    publish(free_counter(*table, descriptors.begin(), consumerId), descriptors.begin(), descriptors.size(), consumerId, 1);
+    ++table->used;
+}
+
+void settings_telemetry::record_read(std::chrono::nanoseconds duration)
+{
+    local_counters().readLatency.record(to_nanoseconds(duration));
+}
+
+telemetry_report settings_telemetry::report() const
+{
+    latency_histogram::counts_t viewCounts{};
+    latency_histogram::counts_t readCounts{};
+    std::map<std::pair<std::uint32_t, std::string_view>, std::uint64_t> accesses;
+
+    for (auto* counters = m_threads.load(std::memory_order_acquire); counters != nullptr; counters = counters->next)
+    {
+        counters->viewLatency.add_to(viewCounts);
+        counters->readLatency.add_to(readCounts);
+
+        const auto* table = counters->views.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i <= table->mask; ++i)
+        {
+            const auto& counter = table->counters[i];
+            const auto* descriptors = counter.descriptors.load(std::memory_order_acquire);
+            if (descriptors == nullptr)
+            {
+                continue;
+            }
+
+            const auto count = counter.count.load(std::memory_order_relaxed);
+            for (const auto& descriptor : setting_descriptors{descriptors, counter.descriptorsCount})
+            {
+                accesses[{counter.consumer, descriptor.path}] += count;
+            }
+        }
+    }
+
+    // the ids were interned before they were published to the counters
+    std::map<std::pair<std::string, std::string_view>, std::uint64_t> namedAccesses;
+    {
+        std::lock_guard<std::mutex> lock{m_consumersMtx};
+        for (const auto& item : accesses)
+        {
+            namedAccesses[{m_consumerNames[item.first.first], item.first.second}] += item.second;
+        }
+    }
+
+    telemetry_report report;
+    report.viewLatency = latency_summary::from_counts(viewCounts);
+    report.readLatency = latency_summary::from_counts(readCounts);
+    report.accesses.reserve(namedAccesses.size());
+    for (const auto& item : namedAccesses)
+    {
+        report.accesses.push_back({item.first.first, std::string{item.first.second}, item.second});
+    }
+
+    return report;
+}
+
+std::unique_ptr<const settings_reader> settings_telemetry::instrument(std::unique_ptr<const settings_reader>&& reader,
+                                                                      std::shared_ptr<settings_telemetry> telemetry)
+{
+    return std::make_unique<instrumented_settings_reader>(std::move(reader), std::move(telemetry));
+}
+
+settings_telemetry::thread_counters& settings_telemetry::local_counters()
+{
+    // the ids of the instances are never reused, i.e. the entries of the destroyed instances are never matched
+    thread_local std::vector<std::pair<std::uint64_t, thread_counters*>> registered;
+    for (const auto& item : registered)
+    {
+        if (item.first == m_id)
+        {
+            return *item.second;
+        }
+    }
+
+    auto counters = std::make_unique<thread_counters>();
+    registered.reserve(registered.size() + 1);
+    counters->next = m_threads.load(std::memory_order_relaxed);
+    while (!m_threads.compare_exchange_weak(counters->next, counters.get(), std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+
+    registered.emplace_back(m_id, counters.get());
+    return *counters.release();
+}
+
+std::uint32_t settings_telemetry::consumer_id(thread_counters& local, const std::string& consumer)
+{
+    const auto localIt = local.consumerIds.find(consumer);
+    if (localIt != local.consumerIds.end())
+    {
+        return localIt->second;
+    }
+
+    std::uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock{m_consumersMtx};
+        const auto inserted = m_consumerIds.try_emplace(consumer, static_cast<std::uint32_t>(m_consumerNames.size()));
+        if (inserted.second)
+        {
+            m_consumerNames.push_back(consumer);
+        }
+        id = inserted.first->second;
+    }
+
+    local.consumerIds.emplace(consumer, id);
+    return id;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "setting_descriptor.h"
+#include "settings_reader.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Lock free histogram of durations with log-linear buckets (as HDR histogram does)
+//! Each power of two is split into sub_buckets_count linear buckets, i.e. the relative error is below 1/sub_buckets_count.
+//! The values above max_value are counted in the last bucket.
+class latency_histogram final
+{
+public:
+    static constexpr std::size_t sub_bucket_bits = 3;
+    static constexpr std::size_t sub_buckets_count = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t max_value_bits = 40;
+    //! about 18 minutes in nanoseconds
+    static constexpr std::uint64_t max_value = (std::uint64_t{1} << max_value_bits) - 1;
+    static constexpr std::size_t buckets_count = (max_value_bits - sub_bucket_bits + 1) * sub_buckets_count;
+
+    using counts_t = std::array<std::uint64_t, buckets_count>;
+
+    latency_histogram() = default;
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    //! Thread safe, lock free
+    void record(std::uint64_t value) noexcept;
+
+    //! Thread safe, adds the counts of the buckets to \p counts
+    //! The concurrently recorded values may or may not be included.
+    void add_to(counts_t& counts) const noexcept;
+
+    static std::size_t bucket_index(std::uint64_t value) noexcept;
+    //! \returns the highest value counted in the bucket with the \p index
+    static std::uint64_t bucket_max(std::size_t index) noexcept;
+
+private:
+    std::array<std::atomic<std::uint64_t>, buckets_count> m_counts{};
+};
+
+//! Statistics of the recorded durations in nanoseconds, the percentiles are the upper bounds of their buckets
+struct latency_summary final
+{
+    std::uint64_t count;
+    std::uint64_t p50;
+    std::uint64_t p90;
+    std::uint64_t p99;
+    std::uint64_t max;
+
+    static latency_summary from_counts(const latency_histogram::counts_t& counts) noexcept;
+};
+
+//! Point in time copy of the settings_telemetry
+struct telemetry_report final
+{
+    //! How many times the \c consumer requested the setting with the \c path
+    struct access final
+    {
+        std::string consumer;
+        std::string path;
+        std::uint64_t count;
+    };
+
+    //! sorted by the consumer and the path
+    std::vector<access> accesses;
+    //! settings_provider::get_view
+    latency_summary viewLatency;
+    //! settings_reader::get, i.e. the views built from the reader (not found in the cache)
+    latency_summary readLatency;
+
+    //! One line per latency and access
+    std::string to_text() const;
+    //! {"view_latency": {...}, "read_latency": {...}, "accesses": [{"consumer": ..., "path": ..., "count": ...}, ...]}
+    std::string to_json() const;
+};
+
+//! Access statistics of a settings_provider, pass it to its constructor
+//! Every thread records to its own counters, i.e. the threads calling settings_provider::get_view
+//! neither share a cache line nor take a lock (except when a thread sees a consumer for the first time).
+//! The counters are relaxed atomics, ::report reads them while they are being written.
+class settings_telemetry final
+{
+public:
+    settings_telemetry();
+    ~settings_telemetry();
+    settings_telemetry(const settings_telemetry&) = delete;
+    settings_telemetry& operator=(const settings_telemetry&) = delete;
+
+    //! Thread safe, the \p consumer requested a view of the \p descriptors
+    //! The views are counted by the address of the \p descriptors, i.e. it has to be a static array (see setting_descriptors_of).
+    void record_view(const std::string& consumer, setting_descriptors descriptors, std::chrono::nanoseconds duration);
+    //! Thread safe
+    void record_read(std::chrono::nanoseconds duration);
+
+    //! Thread safe, lock free with respect to the recording threads
+    telemetry_report report() const;
+
+    //! \returns \p reader that records the duration of its getters
+    static std::unique_ptr<const settings_reader> instrument(std::unique_ptr<const settings_reader>&& reader,
+                                                             std::shared_ptr<settings_telemetry> telemetry);
+
+private:
+    //! The counters and histograms of a single thread, see settings_telemetry.cpp
+    struct thread_counters;
+
+    //! \returns the counters of the calling thread, registers them on the first call
+    thread_counters& local_counters();
+    //! \returns the id of the \p consumer, the ids index m_consumerNames
+    std::uint32_t consumer_id(thread_counters& local, const std::string& consumer);
+
+    //! Unique for each instance, the threads look up their counters by it
+    const std::uint64_t m_id;
+    //! Singly linked list of the counters of all the threads that recorded anything, never shrinks
+    std::atomic<thread_counters*> m_threads;
+
+    //! taken when a thread sees a consumer for the first time and by ::report
+    mutable std::mutex m_consumersMtx;
+    std::unordered_map<std::string, std::uint32_t> m_consumerIds;
+    //! deque, the names do not move when the ids are added
+    std::deque<std::string> m_consumerNames;
+};
@@ -1,13 +1,19 @@
 #pragma once
 
 #include "utils.h"
+#include <memory>
 #include <tuple>
+#include <utility>
 
+//! Immutable values of the setting types \c Args
+//! The values are shared by the copies of the view, i.e. copying the view is cheap
 template <typename... Args>
 class settings_view
 {
 public:
     settings_view(typename Args::value_type&& ... values);
+    //! Aliases the \p values owned by the \p owner (e.g. a snapshot holding more settings), i.e. does not allocate
+    settings_view(std::shared_ptr<const void> owner, const typename Args::value_type&... values) noexcept;
 
     //! Returns the value of the setting type \c T
     //! \tparam T setting type, must be part of the class argument pack \c Args
@@ -15,12 +21,23 @@ public:
     const typename T::value_type& get() const noexcept;
 
 private:
-    std::tuple<typename Args::value_type...> m_values;
+    //! keeps the values alive
+    std::shared_ptr<const void> m_owner;
+    std::tuple<const typename Args::value_type*...> m_values;
 };
 
 template <typename... Args>
 settings_view<Args...>::settings_view(typename Args::value_type&& ... values)
-    : m_values(values ...)
+{
+    auto owner = std::make_shared<const std::tuple<typename Args::value_type...>>(std::move(values)...);
+    m_values = std::apply([](const auto&... ownedValues) { return std::make_tuple(&ownedValues...); }, *owner);
+    m_owner = std::move(owner);
+}
+
+template <typename... Args>
+settings_view<Args...>::settings_view(std::shared_ptr<const void> owner, const typename Args::value_type&... values) noexcept
+    : m_owner(std::move(owner))
+    , m_values(&values...)
 {
 }
 
@@ -28,5 +45,5 @@ template <typename... Args>
 template <typename T, typename>
 const typename T::value_type& settings_view<Args...>::get() const noexcept
 {
-    return std::get<pack_index_v<T,Args...>>(m_values);
+    return *std::get<pack_index_v<T,Args...>>(m_values);
 }
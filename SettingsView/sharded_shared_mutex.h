@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Reader-writer lock with a separate reader counter per thread, i.e. the readers running on different cores
+// do not bounce a single cache line between them. Satisfies the SharedMutex requirements, it can be used
+// as the Mtx of monitor and callback_container (has_lock_shared_method_v detects it).
+//
+// The threads are assigned the reader slots round robin, the count of the slots is the hardware concurrency
+// rounded up to a power of two. The writer announces itself first, then it waits until all the slots are empty,
+// the readers that see the announcement back off, i.e. a continuous read load cannot starve the writer.
+// The lock is more expensive for the writers and takes a cache line per slot, use it for read mostly data.
+class sharded_shared_mutex final
+{
+public:
+    sharded_shared_mutex();
+    sharded_shared_mutex(const sharded_shared_mutex&) = delete;
+    sharded_shared_mutex& operator=(const sharded_shared_mutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) reader_slot final
+    {
+        std::atomic<std::size_t> readers{0};
+    };
+
+    //! \returns the slot of the calling thread
+    reader_slot& slot() noexcept;
+    //! \returns true if there is no reader in any slot
+    bool no_readers() const noexcept;
+
+    std::size_t m_slotsMask;
+    std::unique_ptr<reader_slot[]> m_slots;
+    alignas(cache_line_size) std::atomic<bool> m_writer;
+    //! serializes the writers
+    std::mutex m_writerMtx;
+};
+
+inline sharded_shared_mutex::sharded_shared_mutex()
+    : m_slotsMask{0}
+    , m_writer{false}
+{
+    const auto threadsCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    std::size_t slotsCount = 1;
+    while (slotsCount < threadsCount)
+    {
+        slotsCount *= 2;
+    }
+
+    m_slotsMask = slotsCount - 1;
+    m_slots = std::make_unique<reader_slot[]>(slotsCount);
+}
+
+inline void sharded_shared_mutex::lock()
+{
+    m_writerMtx.lock();
+    m_writer.store(true);
+    while (!no_readers())
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline bool sharded_shared_mutex::try_lock()
+{
+    if (!m_writerMtx.try_lock())
+    {
+        return false;
+    }
+
+    m_writer.store(true);
+    if (!no_readers())
+    {
+        m_writer.store(false);
+        m_writerMtx.unlock();
+        return false;
+    }
+
+    return true;
+}
+
+inline void sharded_shared_mutex::unlock()
+{
+    m_writer.store(false);
+    m_writerMtx.unlock();
+}
+
+inline void sharded_shared_mutex::lock_shared()
+{
+    while (!try_lock_shared())
+    {
+        while (m_writer.load())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+inline bool sharded_shared_mutex::try_lock_shared()
+{
+    // seq_cst ordering guarantees that either the reader sees the writer or the writer sees the reader
+    auto& readerSlot = slot();
+    readerSlot.readers.fetch_add(1);
+    if (!m_writer.load())
+    {
+        return true;
+    }
+
+    readerSlot.readers.fetch_sub(1);
+    return false;
+}
+
+inline void sharded_shared_mutex::unlock_shared()
+{
+    slot().readers.fetch_sub(1, std::memory_order_release);
+}
+
+inline sharded_shared_mutex::reader_slot& sharded_shared_mutex::slot() noexcept
+{
+    static std::atomic<std::size_t> nextThreadIndex{0};
+    thread_local const std::size_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+    return m_slots[threadIndex & m_slotsMask];
+}
+
+inline bool sharded_shared_mutex::no_readers() const noexcept
+{
+    for (std::size_t i = 0; i <= m_slotsMask; ++i)
+    {
+        if (m_slots[i].readers.load() != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//! Identifies an element of slot_map
+//! The slot of an erased element is reused, the generation makes the handles of the erased elements stale
+struct slot_handle final
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+// Stores elements of type T in slots reused through a free list, i.e. insert and erase are O(1)
+// The writers (insert, erase) must be serialized by the caller. for_each does not lock, it can be called
+// from multiple threads concurrently with the writers.
+//
+// The slots are allocated in segments of growing size that are never moved, the readers iterate them in place.
+// Each slot counts the for_each calls visiting it, an empty (detached) slot is skipped before it is counted.
+// erase detaches the element and returns an erased_element, its destruction waits until no for_each of another
+// thread calls the element and releases it. It waits only for the visits that counted the slot before the detach,
+// i.e. it finishes even if the other threads call for_each in a tight loop. Destroy it
+// without holding the lock serializing the writers, an element being called may take it. When the destroying
+// thread calls the element itself (erase from the element), the element is released as soon as that call returns.
+// The slot is reused only after the element is released.
+//
+// Example usage:
+//
+// slot_map<std::string> map;
+// const auto handle = map.insert(std::make_unique<const std::string>("first"));
+// map.for_each([](const std::string& value) { std::cout << value; });
+// map.erase(handle);
+// map.erase(handle);   // stale handle, returns an empty erased_element
+template <typename T>
+class slot_map final
+{
+    struct element;
+    struct slot;
+
+public:
+    using value_t = T;
+
+    //! Element detached by ::erase, the destructor waits for its calls on the other threads and releases it
+    //! Must not outlive the slot_map
+    class erased_element final
+    {
+    public:
+        erased_element() = default;
+        erased_element(erased_element&& other) noexcept;
+        erased_element& operator=(erased_element&& other) noexcept;
+        ~erased_element();
+
+        //! \returns false if the handle passed to ::erase was stale
+        explicit operator bool() const noexcept;
+
+    private:
+        friend slot_map;
+
+        erased_element(const slot_map* map, slot* target, const element* item, std::uint32_t index) noexcept;
+
+        const slot_map* m_map{nullptr};
+        slot* m_slot{nullptr};
+        const element* m_item{nullptr};
+        std::uint32_t m_index{0};
+    };
+
+    slot_map();
+    // the readers iterate the slots in place, copy or move would be confusing
+    slot_map(const slot_map&) = delete;
+    slot_map& operator=(const slot_map&) = delete;
+    ~slot_map();
+
+    // writer, O(1)
+    // throws std::length_error when all the 2^32 slots are in use
+    slot_handle insert(std::unique_ptr<const value_t> value);
+
+    // writer, O(1)
+    // the for_each calls started later do not call the element, see erased_element for the calls in progress
+    // returns an empty erased_element if the \p handle is stale, i.e. its element was erased already (the slot may hold a newer one)
+    erased_element erase(slot_handle handle);
+
+    // thread safe, lock free
+    // calls f(const value_t&) for the elements inserted before for_each was called and not erased yet
+    // the elements inserted meanwhile (e.g. by f itself) are skipped
+    template <typename F>
+    void for_each(F f) const;
+
+private:
+    struct element final
+    {
+        //! order of the insert, the for_each skips the elements inserted after it started
+        std::uint64_t sequence;
+        std::unique_ptr<const value_t> value;
+    };
+
+    struct slot final
+    {
+        std::atomic<const element*> item{nullptr};
+        //! count of the for_each calls visiting the slot, the empty slot is not counted by the new calls
+        mutable std::atomic<std::size_t> readers{0};
+        //! modified by the writers only
+        std::uint32_t generation{0};
+    };
+
+    //! the segment k holds first_segment_size << k slots
+    static constexpr std::size_t first_segment_size = 16;
+    //! enough segments for the 2^32 indexes of slot_handle
+    static constexpr std::size_t segments_count = 28;
+
+    //! Visit of a slot by for_each, the visits of the thread form a stack (the elements can call for_each again)
+    //! Keeps the visit counted even if the called function throws, releases the element if it was erased by the visiting thread
+    class visit final
+    {
+    public:
+        visit(const slot_map* map, slot& target) noexcept;
+        visit(const visit&) = delete;
+        visit& operator=(const visit&) = delete;
+        ~visit();
+
+        //! \returns the innermost visit of the calling thread
+        static visit*& innermost() noexcept;
+
+        const slot_map* map;
+        slot& target;
+        const element* item;
+        visit* outer;
+        //! set by erased_element when the thread erased the visited element, the visit then releases it
+        std::uint32_t releasedIndex;
+        bool release;
+    };
+
+    // writer, the slot must be allocated already
+    slot& at(std::uint32_t index);
+
+    //! Releases the erased element and makes its slot reusable, any thread
+    void release(const element* item, std::uint32_t index) const;
+
+    std::array<std::atomic<slot*>, segments_count> m_segments;
+    //! count of the slots ever used, the readers iterate up to it
+    std::atomic<std::size_t> m_size;
+    //! sequence of the next inserted element, the elements with a lower one are visible to for_each
+    std::atomic<std::uint64_t> m_published;
+
+    std::vector<std::uint32_t> m_free;
+    //! the slots of the released elements, moved to m_free by the next insert
+    mutable std::mutex m_releasedMtx;
+    mutable std::vector<std::uint32_t> m_released;
+};
+
+template <typename T>
+slot_map<T>::erased_element::erased_element(const slot_map* map, slot* target, const element* item, std::uint32_t index) noexcept
+    : m_map{map}
+    , m_slot{target}
+    , m_item{item}
+    , m_index{index}
+{
+}
+
+template <typename T>
+slot_map<T>::erased_element::erased_element(erased_element&& other) noexcept
+    : m_map{std::exchange(other.m_map, nullptr)}
+    , m_slot{std::exchange(other.m_slot, nullptr)}
+    , m_item{std::exchange(other.m_item, nullptr)}
+    , m_index{other.m_index}
+{
+}
+
+template <typename T>
+typename slot_map<T>::erased_element& slot_map<T>::erased_element::operator=(erased_element&& other) noexcept
+{
+    erased_element released{std::move(*this)};
+    m_map = std::exchange(other.m_map, nullptr);
+    m_slot = std::exchange(other.m_slot, nullptr);
+    m_item = std::exchange(other.m_item, nullptr);
+    m_index = other.m_index;
+
+    return *this;
+}
+
+template <typename T>
+slot_map<T>::erased_element::~erased_element()
+{
+    if (m_item == nullptr)
+    {
+        return;
+    }
+
+    // the visits of the calling thread cannot end while it waits, the other threads' ones end eventually
+    // and the new ones see the slot empty (seq_cst ordering with the detaching exchange) and do not count it.
+    // A visit that saw the slot occupied just before the detach counts it only briefly, it loads the item again.
+    std::size_t ownReaders = 0;
+    visit* outermost = nullptr;
+    for (auto current = visit::innermost(); current != nullptr; current = current->outer)
+    {
+        if (&current->target == m_slot)
+        {
+            ++ownReaders;
+            if (current->item == m_item)
+            {
+                outermost = current;
+            }
+        }
+    }
+
+    while (m_slot->readers.load() != ownReaders)
+    {
+        std::this_thread::yield();
+    }
+
+    if (outermost != nullptr)
+    {
+        outermost->releasedIndex = m_index;
+        outermost->release = true;
+        return;
+    }
+
+    m_map->release(m_item, m_index);
+}
+
+template <typename T>
+slot_map<T>::erased_element::operator bool() const noexcept
+{
+    return m_item != nullptr;
+}
+
+template <typename T>
+slot_map<T>::visit::visit(const slot_map* visitedMap, slot& visited) noexcept
+    : map{visitedMap}
+    , target{visited}
+    , item{nullptr}
+    , outer{innermost()}
+    , releasedIndex{0}
+    , release{false}
+{
+    target.readers.fetch_add(1);
+    innermost() = this;
+    item = target.item.load();
+}
+
+template <typename T>
+slot_map<T>::visit::~visit()
+{
+    innermost() = outer;
+    target.readers.fetch_sub(1);
+    if (release)
+    {
+        map->release(item, releasedIndex);
+    }
+}
+
+template <typename T>
+typename slot_map<T>::visit*& slot_map<T>::visit::innermost() noexcept
+{
+    thread_local visit* current = nullptr;
+    return current;
+}
+
+template <typename T>
+slot_map<T>::slot_map()
+    : m_size{0}
+    , m_published{0}
+{
+    for (auto& segment : m_segments)
+    {
+        segment.store(nullptr);
+    }
+}
+
+template <typename T>
+slot_map<T>::~slot_map()
+{
+    // a segment is allocated together with its first slot, i.e. size > index for each allocated one
+    const auto size = m_size.load();
+    std::size_t index = 0;
+    for (std::size_t k = 0; k < segments_count && m_segments[k].load() != nullptr; ++k)
+    {
+        const auto segment = m_segments[k].load();
+        const auto segmentSize = std::min(first_segment_size << k, size - index);
+        for (std::size_t i = 0; i < segmentSize; ++i)
+        {
+            delete segment[i].item.load();
+        }
+        index += first_segment_size << k;
+        delete[] segment;
+    }
+}
+
+template <typename T>
+slot_handle slot_map<T>::insert(std::unique_ptr<const value_t> value)
+{
+    if (m_free.empty())
+    {
+        std::lock_guard<std::mutex> lock{m_releasedMtx};
+        m_free.swap(m_released);
+    }
+
+    std::uint32_t index;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        const auto size = m_size.load();
+        // the first index of segment k is first_segment_size * (2^k - 1)
+        const auto capacity = first_segment_size * ((std::size_t{1} << segments_count) - 1);
+        if (size == capacity)
+        {
+            throw std::length_error("slot_map is full");
+        }
+
+        std::size_t k = 0;
+        std::size_t segmentStart = 0;
+        while (size >= segmentStart + (first_segment_size << k))
+        {
+            segmentStart += first_segment_size << k;
+            ++k;
+        }
+        if (size == segmentStart)
+        {
+            // published before m_size, the readers never see a slot without its segment
+            m_segments[k].store(new slot[first_segment_size << k]);
+        }
+
+        index = static_cast<std::uint32_t>(size);
+        m_size.store(size + 1);
+    }
+
+    auto& target = at(index);
+    const auto sequence = m_published.load();
+    target.item.store(new element{sequence, std::move(value)});
+    m_published.store(sequence + 1);
+
+    return slot_handle{index, target.generation};
+}
+
+template <typename T>
+typename slot_map<T>::erased_element slot_map<T>::erase(slot_handle handle)
+{
+    if (handle.index >= m_size.load())
+    {
+        return {};
+    }
+
+    auto& target = at(handle.index);
+    if (target.generation != handle.generation || target.item.load() == nullptr)
+    {
+        return {};
+    }
+
+    const auto item = target.item.exchange(nullptr);
+    ++target.generation;
+
+    return erased_element(this, &target, item, handle.index);
+}
+
+template <typename T>
+template <typename F>
+void slot_map<T>::for_each(F f) const
+{
+    const auto published = m_published.load();
+    const auto size = m_size.load();
+
+    std::size_t index = 0;
+    for (std::size_t k = 0; index < size; ++k)
+    {
+        slot* segment = m_segments[k].load();
+        const auto segmentSize = std::min(first_segment_size << k, size - index);
+        for (std::size_t i = 0; i < segmentSize; ++i)
+        {
+            // the detached slot is not counted, otherwise the back to back visits could keep the erased_element waiting
+            if (segment[i].item.load() == nullptr)
+            {
+                continue;
+            }
+
+            // counted before the element is loaded again, the erased_element waits for it
+            const visit current{this, segment[i]};
+            if (current.item != nullptr && current.item->sequence < published)
+            {
+                f(static_cast<const value_t&>(*current.item->value));
+            }
+        }
+        index += first_segment_size << k;
+    }
+}
+
+template <typename T>
+typename slot_map<T>::slot& slot_map<T>::at(std::uint32_t index)
+{
+    std::size_t k = 0;
+    std::size_t offset = index;
+    while (offset >= first_segment_size << k)
+    {
+        offset -= first_segment_size << k;
+        ++k;
+    }
+
+    return m_segments[k].load()[offset];
+}
+
+template <typename T>
+void slot_map<T>::release(const element* item, std::uint32_t index) const
+{
+    delete item;
+
+    std::lock_guard<std::mutex> lock{m_releasedMtx};
+    m_released.push_back(index);
+}
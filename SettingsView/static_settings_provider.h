@@ -0,0 +1,125 @@
+#pragma once
+
+#include "lazy_settings_view.h"
+#include "rcu_ptr.h"
+#include "settings_reader.h"
+#include "settings_snapshot.h"
+#include "settings_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+//! Detects the batch getter of settings_reader, the only one used by static_settings_provider
+template <typename Reader, typename = void>
+struct is_settings_reader : std::false_type
+{
+};
+
+template <typename Reader>
+struct is_settings_reader<Reader, std::void_t<decltype(std::declval<const Reader&>().get(std::declval<const setting_request*>(), std::size_t{}))>>
+    : std::true_type
+{
+};
+
+template <typename Reader>
+constexpr auto is_settings_reader_v = is_settings_reader<Reader>::value;
+
+//! settings_provider over the concrete \c Reader type (e.g. json_settings_reader)
+//! The batch read calls \c Reader::get without the virtual dispatch, once per view built for a generation (the cached
+//! views are not read at all). The lookup itself is not inlined nor constant folded: the readers define their batch
+//! getter out of line and compiled_path resolves the path at runtime, i.e. expect no measurable gain over
+//! settings_provider on the cached path. Use settings_provider when the reader type is known at runtime only,
+//! or when the observers, subscriptions or telemetry are needed.
+//! The snapshots and the cached views are those of settings_provider (see settings_snapshot), only the reader call differs.
+template <typename Reader>
+class static_settings_provider final
+{
+    // a Reader overriding only the single value getters has to bring the batch one in by using settings_reader::get
+    static_assert(is_settings_reader_v<Reader>, "Reader must provide get(const setting_request*, std::size_t) const");
+
+public:
+    using reader_t = Reader;
+    using generation_t = std::uint64_t;
+
+    //! Throws std::invalid_argument when the \p settingsReader is null
+    explicit static_settings_provider(std::unique_ptr<Reader>&& settingsReader);
+
+    //! Thread safe, never blocks on a concurrent ::reload
+    template <typename... Args>
+    settings_view<Args...> get_view() const;
+
+    //! As ::get_view, but each of the \c Args is parsed by the first lazy_settings_view::get of it
+    template <typename... Args>
+    lazy_settings_view<Args...> get_lazy_view() const;
+
+    //! Thread safe, replaces the settings for all subsequent ::get_view calls
+    //! \returns generation of the published settings
+    generation_t reload(std::unique_ptr<Reader>&& settingsReader);
+
+    //! Generation of the currently published settings, starts with 0 and is incremented with each ::reload
+    generation_t generation() const;
+
+private:
+    using snapshot = settings_snapshot<Reader>;
+
+    static std::unique_ptr<const Reader> not_null(std::unique_ptr<Reader>&& settingsReader);
+
+    rcu_ptr<snapshot> m_snapshot;
+};
+
+template <typename Reader>
+static_settings_provider<Reader>::static_settings_provider(std::unique_ptr<Reader>&& settingsReader)
+    : m_snapshot{std::make_shared<const snapshot>(not_null(std::move(settingsReader)), 0)}
+{
+}
+
+template <typename Reader>
+template <typename... Args>
+settings_view<Args...> static_settings_provider<Reader>::get_view() const
+{
+    // keeps the snapshot alive even when a reload is published in the meantime
+    const auto current = m_snapshot.load();
+
+    return current->template view<Args...>();
+}
+
+template <typename Reader>
+template <typename... Args>
+lazy_settings_view<Args...> static_settings_provider<Reader>::get_lazy_view() const
+{
+    const auto current = m_snapshot.load();
+
+    return current->template lazy_view<Args...>();
+}
+
+template <typename Reader>
+typename static_settings_provider<Reader>::generation_t static_settings_provider<Reader>::reload(std::unique_ptr<Reader>&& settingsReader)
+{
+    auto reader = not_null(std::move(settingsReader));
+    const auto published = m_snapshot.update([&reader](const std::shared_ptr<const snapshot>& current) {
+        return std::make_shared<const snapshot>(std::move(reader), current->generation + 1);
+    });
+
+    return published->generation;
+}
+
+template <typename Reader>
+typename static_settings_provider<Reader>::generation_t static_settings_provider<Reader>::generation() const
+{
+    return m_snapshot.load()->generation;
+}
+
+template <typename Reader>
+std::unique_ptr<const Reader> static_settings_provider<Reader>::not_null(std::unique_ptr<Reader>&& settingsReader)
+{
+    if (!settingsReader)
+    {
+        throw std::invalid_argument("settingsReader must not be null");
+    }
+
+    return std::move(settingsReader);
+}
@@ -0,0 +1,604 @@
+#include "pch.h"
+
+#include "streaming_json_settings_reader.h"
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/filereadstream.h>
+#include <rapidjson/reader.h>
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+namespace
+{
+    using file_ptr = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+    file_ptr open_file(const std::string& fileName)
+    {
+#ifdef _WIN32
+        std::FILE* file = nullptr;
+        if (fopen_s(&file, fileName.c_str(), "rb") != 0)
+        {
+            file = nullptr;
+        }
+#else
+        const auto file = std::fopen(fileName.c_str(), "rb");
+#endif
+        if (file == nullptr)
+        {
+            throw std::runtime_error("Cannot open file '" + fileName + "'");
+        }
+
+        return file_ptr(file, &std::fclose);
+    }
+
+    //! Appends the \p name escaped as settings_path::escape does, without the temporary string
+    void append_escaped(std::string& key, std::string_view name)
+    {
+        for (const auto c : name)
+        {
+            if (c == '~')
+            {
+                key += "~0";
+            }
+            else if (c == settings_path::separator)
+            {
+                key += "~1";
+            }
+            else
+            {
+                key += c;
+            }
+        }
+    }
+
+    //! \returns the narrowest of int, std::int64_t and double holding the integer \p value, the same as json_settings_reader::for_each
+    template <typename T>
+    setting_value to_number(T value)
+    {
+        // none of the T is narrower than int, the comparisons are done in T
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+            {
+                return setting_value{static_cast<std::int64_t>(value)};
+            }
+        }
+        else
+        {
+            if (value > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+            {
+                return setting_value{static_cast<double>(value)};
+            }
+            if (value > static_cast<unsigned>(std::numeric_limits<int>::max()))
+            {
+                return setting_value{static_cast<std::int64_t>(value)};
+            }
+        }
+
+        return setting_value{static_cast<int>(value)};
+    }
+
+    constexpr std::size_t readBufferSize = 64 * 1024;
+}  // namespace
+
+//! Tracks the key of the current value and copies the values of the registered keys
+//! The containers that are neither registered nor on the way to a registered key are skipped, only their depth is counted.
+//! The items of a registered array are collected until an item other than a number is met.
+class streaming_json_settings_reader::handler final : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, handler>
+{
+public:
+    handler(streaming_json_settings_reader& reader, const std::unordered_set<std::string>& keys, const std::unordered_set<std::string>& prefixes)
+        : m_reader{reader}
+        , m_keys{keys}
+        , m_prefixes{prefixes}
+        , m_skipDepth{0}
+        , m_rootNotObject{false}
+    {
+    }
+
+    //! \returns true if the parsing was stopped because all the registered settings were found
+    bool complete() const noexcept
+    {
+        return m_reader.m_settings.size() + m_reader.m_arrays.size() == m_keys.size();
+    }
+
+    bool root_not_object() const noexcept
+    {
+        return m_rootNotObject;
+    }
+
+    bool StartObject()
+    {
+        return start_container(false);
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+        return end_container();
+    }
+
+    bool StartArray()
+    {
+        return start_container(true);
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        return end_container();
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool)
+    {
+        if (m_skipDepth == 0)
+        {
+            m_key.resize(m_frames.back().keyLength);
+            append_separator();
+            append_escaped(m_key, std::string_view(str, length));
+        }
+
+        return true;
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool)
+    {
+        return scalar(setting_value{std::string_view(str, length)});
+    }
+
+    bool Int(int value)
+    {
+        return scalar(setting_value{value});
+    }
+
+    bool Uint(unsigned value)
+    {
+        return scalar(to_number(value));
+    }
+
+    bool Int64(std::int64_t value)
+    {
+        return scalar(to_number(value));
+    }
+
+    bool Uint64(std::uint64_t value)
+    {
+        return scalar(to_number(value));
+    }
+
+    bool Double(double value)
+    {
+        return scalar(setting_value{value});
+    }
+
+    bool Bool(bool value)
+    {
+        return scalar(setting_value{value});
+    }
+
+    // null cannot be read by the getters, its key is tracked only
+    bool Null()
+    {
+        return scalar(std::nullopt);
+    }
+
+private:
+    struct frame final
+    {
+        std::size_t keyLength;
+        bool isArray;
+        std::size_t nextIndex;
+        //! the numbers of a registered array, std::nullopt when the container is not collected (any longer)
+        std::optional<number_array> items;
+    };
+
+    void append_separator()
+    {
+        if (!m_key.empty())
+        {
+            m_key += settings_path::separator;
+        }
+    }
+
+    //! Sets ::m_key to the key of the value being started
+    //! \returns false if the value is in a skipped container
+    bool value_key()
+    {
+        if (m_skipDepth != 0)
+        {
+            return false;
+        }
+
+        // the key of an object member is set by ::Key
+        if (!m_frames.empty() && m_frames.back().isArray)
+        {
+            auto& parent = m_frames.back();
+            m_key.resize(parent.keyLength);
+            append_separator();
+
+            char index[std::numeric_limits<std::size_t>::digits10 + 1];
+            const auto result = std::to_chars(std::begin(index), std::end(index), parent.nextIndex++);
+            m_key.append(index, result.ptr);
+        }
+
+        return true;
+    }
+
+    bool start_container(bool isArray)
+    {
+        if (m_frames.empty() && m_skipDepth == 0 && isArray)
+        {
+            m_rootNotObject = true;
+            return false;
+        }
+
+        if (!value_key())
+        {
+            ++m_skipDepth;
+            return true;
+        }
+
+        // the root is always entered, its key is empty
+        const auto collected = isArray && !m_frames.empty() && m_keys.count(m_key) != 0;
+        if (!m_frames.empty())
+        {
+            // a nested container is not a number
+            m_frames.back().items.reset();
+        }
+        if (!m_frames.empty() && m_prefixes.count(m_key) == 0 && !collected)
+        {
+            m_skipDepth = 1;
+            return true;
+        }
+
+        m_frames.push_back(frame{m_key.size(), isArray, 0, collected ? std::make_optional<number_array>() : std::nullopt});
+        return true;
+    }
+
+    bool end_container()
+    {
+        if (m_skipDepth != 0)
+        {
+            --m_skipDepth;
+            return true;
+        }
+
+        if (auto& items = m_frames.back().items)
+        {
+            m_reader.add_array(m_key.substr(0, m_frames.back().keyLength), std::move(*items));
+        }
+        m_frames.pop_back();
+        if (!m_frames.empty())
+        {
+            m_key.resize(m_frames.back().keyLength);
+        }
+
+        // stops the parsing, there is nothing more to read
+        return !complete();
+    }
+
+    bool scalar(const std::optional<setting_value>& value)
+    {
+        if (m_frames.empty() && m_skipDepth == 0)
+        {
+            m_rootNotObject = true;
+            return false;
+        }
+
+        if (!value_key())
+        {
+            return true;
+        }
+
+        if (auto& items = m_frames.back().items)
+        {
+            // appended straight to the contiguous buffer, the setting_value of an item is never stored
+            if (const auto integer = value ? std::get_if<int>(&*value) : nullptr)
+            {
+                items->push_back(std::int64_t{*integer});
+            }
+            else if (const auto integer64 = value ? std::get_if<std::int64_t>(&*value) : nullptr)
+            {
+                items->push_back(*integer64);
+            }
+            else if (const auto real = value ? std::get_if<double>(&*value) : nullptr)
+            {
+                items->push_back(*real);
+            }
+            else
+            {
+                items.reset();
+            }
+        }
+
+        if (!value || m_keys.count(m_key) == 0)
+        {
+            return true;
+        }
+
+        m_reader.add(m_key, *value);
+        return !complete();
+    }
+
+    streaming_json_settings_reader& m_reader;
+    const std::unordered_set<std::string>& m_keys;
+    const std::unordered_set<std::string>& m_prefixes;
+
+    //! key of the current value, see settings_path::key
+    std::string m_key;
+    //! the entered containers, the root object first
+    std::vector<frame> m_frames;
+    //! depth of the skipped containers, zero when the current value is not skipped
+    std::size_t m_skipDepth;
+    bool m_rootNotObject;
+};
+
+streaming_json_settings_reader::streaming_json_settings_reader(const std::string& fileName, const std::vector<settings_path>& paths)
+{
+    std::unordered_set<std::string> keys;
+    // the keys of the containers on the way to the registered settings
+    std::unordered_set<std::string> prefixes;
+    for (const auto& path : paths)
+    {
+        const auto& key = path.key();
+        keys.insert(key);
+        for (auto separatorPos = key.find(settings_path::separator); separatorPos != std::string::npos;
+             separatorPos = key.find(settings_path::separator, separatorPos + 1))
+        {
+            prefixes.insert(key.substr(0, separatorPos));
+        }
+    }
+
+    const auto file = open_file(fileName);
+    std::vector<char> buffer(readBufferSize);
+    rapidjson::FileReadStream stream(file.get(), buffer.data(), buffer.size());
+
+    handler settingsHandler{*this, keys, prefixes};
+    rapidjson::Reader reader;
+    const auto result = reader.Parse(stream, settingsHandler);
+
+    if (settingsHandler.root_not_object())
+    {
+        throw std::runtime_error("Settings root is not an object");
+    }
+    if (result.IsError() && !settingsHandler.complete())
+    {
+        throw std::runtime_error(rapidjson::GetParseError_En(result.Code()));
+    }
+}
+
+void streaming_json_settings_reader::get(int& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(std::string& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(std::string_view& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(std::int64_t& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(double& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(bool& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(numeric_array<double>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(numeric_array<std::int64_t>& value, const settings_path& path) const
+{
+    const setting_request request{&path, &value};
+    get(&request, 1);
+}
+
+void streaming_json_settings_reader::get(const setting_request* requests, std::size_t count) const
+{
+    settings_errors errors;
+    for (auto request = requests; request != requests + count; ++request)
+    {
+        if (const auto code = read(*request))
+        {
+            errors.add(*request, *code);
+        }
+    }
+
+    errors.throw_if_any();
+}
+
+void streaming_json_settings_reader::for_each(const visitor_t& visitor) const
+{
+    for (const auto& setting : m_settings)
+    {
+        visitor(setting.first, setting.second);
+    }
+
+    std::string key;
+    for (const auto& array : m_arrays)
+    {
+        for (std::size_t i = 0; i < array.second.size(); ++i)
+        {
+            key = array.first;
+            key += settings_path::separator;
+            key += std::to_string(i);
+            // an item registered on its own is enumerated above already
+            if (m_settings.find(key) == m_settings.end())
+            {
+                visitor(key, array.second.item(i));
+            }
+        }
+    }
+}
+
+void streaming_json_settings_reader::for_each_array(const array_visitor_t& visitor) const
+{
+    for (const auto& array : m_arrays)
+    {
+        visitor(array.first);
+    }
+}
+
+std::size_t streaming_json_settings_reader::size() const noexcept
+{
+    return m_settings.size() + m_arrays.size();
+}
+
+void streaming_json_settings_reader::add(const std::string& key, const setting_value& value)
+{
+    if (m_settings.find(key) != m_settings.end() || m_arrays.find(key) != m_arrays.end())
+    {
+        return;
+    }
+
+    if (const auto string = std::get_if<std::string_view>(&value))
+    {
+        m_settings.emplace(key, std::string_view(m_strings.emplace_back(*string)));
+        return;
+    }
+
+    m_settings.emplace(key, value);
+}
+
+std::size_t streaming_json_settings_reader::number_array::size() const noexcept
+{
+    return integers.size();
+}
+
+void streaming_json_settings_reader::number_array::push_back(std::int64_t item)
+{
+    integers.push_back(item);
+    if (!reals.empty())
+    {
+        reals.push_back(static_cast<double>(item));
+        integerItems.push_back(true);
+    }
+}
+
+void streaming_json_settings_reader::number_array::push_back(double item)
+{
+    if (reals.empty())
+    {
+        reals.resize(integers.size());
+        convert_numbers(integers.data(), integers.size(), reals.data());
+        integerItems.assign(integers.size(), true);
+    }
+
+    integers.push_back(0);
+    reals.push_back(item);
+    integerItems.push_back(false);
+}
+
+setting_value streaming_json_settings_reader::number_array::item(std::size_t index) const
+{
+    if (!reals.empty() && !integerItems[index])
+    {
+        return setting_value{reals[index]};
+    }
+
+    return to_number(integers[index]);
+}
+
+template <typename T>
+bool streaming_json_settings_reader::convert_array(const number_array&, T&)
+{
+    return false;
+}
+
+bool streaming_json_settings_reader::convert_array(const number_array& items, numeric_array<double>& value)
+{
+    numeric_array<double> result(items.size());
+    if (items.reals.empty())
+    {
+        convert_numbers(items.integers.data(), items.size(), result.data());
+    }
+    else
+    {
+        convert_numbers(items.reals.data(), items.size(), result.data());
+    }
+
+    value = std::move(result);
+    return true;
+}
+
+bool streaming_json_settings_reader::convert_array(const number_array& items, numeric_array<std::int64_t>& value)
+{
+    if (!items.reals.empty())
+    {
+        return false;
+    }
+
+    numeric_array<std::int64_t> result(items.size());
+    convert_numbers(items.integers.data(), items.size(), result.data());
+
+    value = std::move(result);
+    return true;
+}
+
+void streaming_json_settings_reader::add_array(const std::string& key, number_array&& items)
+{
+    if (m_settings.find(key) != m_settings.end())
+    {
+        return;
+    }
+
+    m_arrays.emplace(key, std::move(items));
+}
+
+std::optional<setting_errc> streaming_json_settings_reader::read(const setting_request& request) const
+{
+    const auto settingIt = m_settings.find(request.path->key());
+    if (settingIt == m_settings.end())
+    {
+        const auto arrayIt = m_arrays.find(request.path->key());
+        if (arrayIt == m_arrays.end())
+        {
+            return setting_errc::not_found;
+        }
+
+        const auto converted =
+            std::visit([arrayIt](auto destination) { return convert_array(arrayIt->second, *destination); }, request.destination);
+        if (!converted)
+        {
+            return setting_errc::type_mismatch;
+        }
+
+        return std::nullopt;
+    }
+
+    const auto converted =
+        std::visit([settingIt](auto destination) { return convert_setting(settingIt->second, *destination); }, request.destination);
+    if (!converted)
+    {
+        return setting_errc::type_mismatch;
+    }
+
+    return std::nullopt;
+}
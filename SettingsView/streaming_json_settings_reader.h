@@ -0,0 +1,102 @@
+#pragma once
+
+#include "settings_path.h"
+#include "settings_reader.h"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//! Reads only the registered settings of a JSON file, without building the document
+//! The file is parsed by the rapidjson SAX reader through a fixed size buffer. The scalar values
+//! of the registered \p paths are copied, all the other subtrees are skipped as they are tokenized,
+//! i.e. the memory use depends on the registered settings only, not on the size of the file.
+//! The parsing stops as soon as all the registered settings are found, the rest of the file is not validated.
+//! A registered array of numbers is collected as a whole, i.e. it is readable as numeric_array. The registered settings
+//! missing in the file or being null, an object or an array of other items are reported as not found by the getters.
+class streaming_json_settings_reader final : public settings_reader
+{
+public:
+    //! Throws std::runtime_error when the file cannot be read or its root is not an object
+    streaming_json_settings_reader(const std::string& fileName, const std::vector<settings_path>& paths);
+
+    //! Registers the paths of the setting types \c Args
+    template <typename... Args>
+    static std::unique_ptr<streaming_json_settings_reader> create(const std::string& fileName);
+
+    void get(int& value, const settings_path& path) const override;
+
+    void get(std::string& value, const settings_path& path) const override;
+    //! The \p value points to the storage of the reader
+    void get(std::string_view& value, const settings_path& path) const override;
+
+    void get(std::int64_t& value, const settings_path& path) const override;
+    void get(double& value, const settings_path& path) const override;
+    void get(bool& value, const settings_path& path) const override;
+    void get(numeric_array<double>& value, const settings_path& path) const override;
+    void get(numeric_array<std::int64_t>& value, const settings_path& path) const override;
+
+    void get(const setting_request* requests, std::size_t count) const override;
+
+    //! Enumerates the registered settings found in the file, the items of the registered arrays included
+    void for_each(const visitor_t& visitor) const override;
+    //! Enumerates the registered arrays found in the file
+    void for_each_array(const array_visitor_t& visitor) const override;
+
+    //! \returns the count of the registered settings (the arrays included) found in the file
+    std::size_t size() const noexcept;
+
+private:
+    //! Reads the single \p request without throwing, the batch ::get and the default settings_reader::try_get call it
+    std::optional<setting_errc> read(const setting_request& request) const override;
+
+    class handler;
+
+    //! The items of a registered array of numbers, collected by the handler as they are parsed
+    //! The arrays of integers (the usual case) are a single std::int64_t buffer, they are copied to numeric_array
+    //! in bulk (see convert_numbers). The first item other than an integer switches the array to a double buffer.
+    struct number_array final
+    {
+        //! All the items while they are integers, then the integer items at their indexes (zero for the others)
+        std::vector<std::int64_t> integers;
+        //! Empty while all the items are integers, then all the items converted to double
+        std::vector<double> reals;
+        //! Empty while all the items are integers, then set for the integer items
+        std::vector<bool> integerItems;
+
+        std::size_t size() const noexcept;
+        void push_back(std::int64_t item);
+        void push_back(double item);
+        //! \returns the item with the \p index as it was parsed, i.e. as int, std::int64_t or double
+        setting_value item(std::size_t index) const;
+    };
+
+    //! Converts the \p items to \p value, only numeric_array is convertible
+    template <typename T>
+    static bool convert_array(const number_array& items, T& value);
+    static bool convert_array(const number_array& items, numeric_array<double>& value);
+    static bool convert_array(const number_array& items, numeric_array<std::int64_t>& value);
+
+    //! The first value of the \p key wins, the same one json_settings_reader returns for duplicate members
+    void add(const std::string& key, const setting_value& value);
+    //! As ::add, the \p items are the numbers of the array
+    void add_array(const std::string& key, number_array&& items);
+
+    //! The storage of the string values, the deque does not move its elements when growing
+    std::deque<std::string> m_strings;
+    //! The key is settings_path::key
+    std::unordered_map<std::string, setting_value> m_settings;
+    //! The registered arrays of numbers, the key is settings_path::key
+    std::unordered_map<std::string, number_array> m_arrays;
+};
+
+template <typename... Args>
+std::unique_ptr<streaming_json_settings_reader> streaming_json_settings_reader::create(const std::string& fileName)
+{
+    return std::make_unique<streaming_json_settings_reader>(fileName, std::vector<settings_path>{compiled_path<Args>()...});
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
 
 template <class T, class... Ts>
@@ -22,6 +24,30 @@ struct pack_index<T, U, Ts...> : std::integral_constant<std::size_t, 1 + pack_in
 template <typename T, typename... Ts>
 constexpr auto pack_index_v = pack_index<T, Ts...>::value;
 
+// Unique identifier of a type (or a type pack), unlike std::type_index it is cheap to hash and compare
+// The id is writable on purpose, identical read-only constants may be folded into one by the linker (MSVC /OPT:ICF)
+template <typename... Ts>
+struct type_tag
+{
+    inline static char id{};
+};
+
+template <typename... Ts>
+constexpr const void* type_id_v = &type_tag<Ts...>::id;
+
+// 64-bit FNV-1a hash, unlike std::hash it is the same on all platforms, i.e. it can be persisted
+constexpr std::uint64_t fnv1a_64(std::string_view data) noexcept
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const auto c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
 // I hate macros but this is super helpful
 // taken from https://stackoverflow.com/a/9544792
 //
@@ -42,4 +68,4 @@ struct has_method_helper
     {                                                                                                                                 \
     };                                                                                                                                \
     template <typename T>                                                                                                             \
-    constexpr auto has_##methodname##_method_v = has_##methodname##_method<T>::value;
\ No newline at end of file
+    constexpr auto has_##methodname##_method_v = has_##methodname##_method<T>::value;
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "rcu_ptr.h"
+#include "settings_path.h"
+#include "settings_reader.h"
+#include "settings_view.h"
+#include "utils.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+//! settings_provider of a fixed set of the setting types \c Args, i.e. of the schema of the application
+//! The construction and each ::reload read and parse all the \c Args up front and report every missing, mistyped
+//! or unparsable setting together. The published snapshot holds the parsed values, i.e. ::get_view of any subset
+//! of \c Args cannot fail: it neither reads, parses nor allocates. The snapshot keeps the reader as well, values
+//! referring to its storage (e.g. std::string_view) stay valid as long as a view of the snapshot exists.
+//! Use settings_provider when the setting types are not known up front, or when the observers, subscriptions
+//! or telemetry are needed.
+template <typename... Args>
+class validated_settings_provider final
+{
+public:
+    using generation_t = std::uint64_t;
+
+    //! Throws std::invalid_argument when the \p settingsReader is null
+    //! Throws a single std::runtime_error describing every invalid setting (one per line)
+    explicit validated_settings_provider(std::unique_ptr<settings_reader>&& settingsReader);
+
+    //! Thread safe, lock free, the view aliases the values of the current snapshot
+    //! \tparam Ts setting types, each of them must be part of the class argument pack \c Args
+    template <typename... Ts>
+    settings_view<Ts...> get_view() const noexcept;
+
+    //! Thread safe, validates the \p settingsReader as the constructor does and publishes its settings
+    //! Throws as the constructor, the previously published settings stay in place then
+    //! \returns generation of the published settings
+    generation_t reload(std::unique_ptr<settings_reader>&& settingsReader);
+
+    //! Generation of the currently published settings, starts with 0 and is incremented with each ::reload
+    generation_t generation() const noexcept;
+
+private:
+    using values_t = std::tuple<typename Args::value_type...>;
+
+    struct snapshot final
+    {
+        snapshot(std::unique_ptr<settings_reader>&& settingsReader, values_t&& settingsValues, generation_t settingsGeneration);
+
+        //! The storage of the values read as e.g. std::string_view, released with the snapshot
+        std::unique_ptr<settings_reader> reader;
+        values_t values;
+        generation_t generation;
+    };
+
+    //! Validates the \p settingsReader, the snapshot takes it over along with the values
+    static std::shared_ptr<const snapshot> make_snapshot(std::unique_ptr<settings_reader>&& settingsReader, generation_t generation);
+
+    //! Reads and parses all the \c Args from the \p settingsReader, throws as the constructor
+    static values_t validate(const std::unique_ptr<settings_reader>& settingsReader);
+
+    template <std::size_t... I>
+    static values_t validate(const settings_reader& reader, std::index_sequence<I...>);
+
+    //! Parses the \p source of the readable setting \c T to \p value, adds the failure to the \p errors
+    template <typename T>
+    static void parse(bool readable, typename T::source_type& source, std::optional<typename T::value_type>& value, settings_errors& errors);
+
+    rcu_ptr<snapshot> m_snapshot;
+};
+
+template <typename... Args>
+validated_settings_provider<Args...>::snapshot::snapshot(std::unique_ptr<settings_reader>&& settingsReader,
+                                                         values_t&& settingsValues,
+                                                         generation_t settingsGeneration)
+    : reader{std::move(settingsReader)}
+    , values{std::move(settingsValues)}
+    , generation{settingsGeneration}
+{
+}
+
+template <typename... Args>
+validated_settings_provider<Args...>::validated_settings_provider(std::unique_ptr<settings_reader>&& settingsReader)
+    : m_snapshot{make_snapshot(std::move(settingsReader), 0)}
+{
+}
+
+template <typename... Args>
+template <typename... Ts>
+settings_view<Ts...> validated_settings_provider<Args...>::get_view() const noexcept
+{
+    static_assert((is_any_of<Ts, Args...> && ...), "the setting types must be validated by the provider, i.e. be part of Args");
+
+    auto current = m_snapshot.load();
+    const auto& values = current->values;
+
+    return settings_view<Ts...>(std::move(current), std::get<pack_index_v<Ts, Args...>>(values)...);
+}
+
+template <typename... Args>
+typename validated_settings_provider<Args...>::generation_t validated_settings_provider<Args...>::reload(
+    std::unique_ptr<settings_reader>&& settingsReader)
+{
+    auto values = validate(settingsReader);
+    const auto published = m_snapshot.update([&settingsReader, &values](const std::shared_ptr<const snapshot>& current) {
+        return std::make_shared<const snapshot>(std::move(settingsReader), std::move(values), current->generation + 1);
+    });
+
+    return published->generation;
+}
+
+template <typename... Args>
+typename validated_settings_provider<Args...>::generation_t validated_settings_provider<Args...>::generation() const noexcept
+{
+    return m_snapshot.load()->generation;
+}
+
+template <typename... Args>
+std::shared_ptr<const typename validated_settings_provider<Args...>::snapshot> validated_settings_provider<Args...>::make_snapshot(
+    std::unique_ptr<settings_reader>&& settingsReader, generation_t generation)
+{
+    auto values = validate(settingsReader);
+    return std::make_shared<const snapshot>(std::move(settingsReader), std::move(values), generation);
+}
+
+template <typename... Args>
+typename validated_settings_provider<Args...>::values_t validated_settings_provider<Args...>::validate(
+    const std::unique_ptr<settings_reader>& settingsReader)
+{
+    if (!settingsReader)
+    {
+        throw std::invalid_argument("settingsReader must not be null");
+    }
+
+    return validate(*settingsReader, std::index_sequence_for<Args...>{});
+}
+
+template <typename... Args>
+template <std::size_t... I>
+typename validated_settings_provider<Args...>::values_t validated_settings_provider<Args...>::validate(const settings_reader& reader,
+                                                                                                         std::index_sequence<I...>)
+{
+    std::tuple<typename Args::source_type...> sources;
+    const std::array<setting_request, sizeof...(Args)> requests{{{&compiled_path<Args>(), &std::get<I>(sources)}...}};
+
+    settings_errors errors;
+    std::array<bool, sizeof...(Args)> readable{};
+    try
+    {
+        reader.get(requests.data(), requests.size());
+        readable.fill(true);
+    }
+    catch (const std::runtime_error&)
+    {
+        // one by one only when the batch fails, to parse (and validate) the readable settings as well
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            try
+            {
+                reader.get(&requests[i], 1);
+                readable[i] = true;
+            }
+            catch (const std::runtime_error& ex)
+            {
+                errors.add(ex.what());
+            }
+        }
+    }
+
+    std::tuple<std::optional<typename Args::value_type>...> values;
+    (parse<Args>(readable[I], std::get<I>(sources), std::get<I>(values), errors), ...);
+    errors.throw_if_any();
+
+    return values_t(std::move(*std::get<I>(values))...);
+}
+
+template <typename... Args>
+template <typename T>
+void validated_settings_provider<Args...>::parse(bool readable, typename T::source_type& source, std::optional<typename T::value_type>& value,
+                                                 settings_errors& errors)
+{
+    if (!readable)
+    {
+        return;
+    }
+
+    try
+    {
+        value.emplace(T::parse(std::move(source)));
+    }
+    catch (const std::exception& ex)
+    {
+        errors.add(("Member '" + compiled_path<T>().str() + "' is invalid: " + ex.what()).c_str());
+    }
+}
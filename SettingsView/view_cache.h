@@ -0,0 +1,99 @@
+#pragma once
+
+#include "rcu_ptr.h"
+#include "settings_reader.h"
+#include "utils.h"
+
+#include <memory>
+#include <unordered_map>
+
+//! Views already built from a single snapshot of the settings, each of them is built only once
+//! Thread safe, a lookup never blocks. The cache is dropped together with its snapshot.
+class view_cache final
+{
+public:
+    view_cache();
+
+    //! \returns the cached view of the type \c View (e.g. settings_view<Args...>), builds it by \p build and caches it if there is none
+    //! A view that failed to be built (i.e. \p build threw) is not cached, the next call will try again
+    template <typename View, typename F>
+    View get(F&& build) const;
+
+    //! As ::get, but the \p build returns setting_result<View>, its failure is returned (and not cached)
+    template <typename View, typename F>
+    setting_result<View> try_get(F&& build) const;
+
+private:
+    //! \returns the cached view of the type \c View or nullptr
+    template <typename View>
+    std::shared_ptr<const View> find() const;
+
+    void add(const void* key, std::shared_ptr<const void> view) const;
+
+    //! The key is type_id_v of the view type and the value the view itself
+    using views_t = std::unordered_map<const void*, std::shared_ptr<const void>>;
+
+    mutable rcu_ptr<views_t> m_views;
+};
+
+inline view_cache::view_cache()
+    : m_views{std::make_shared<const views_t>()}
+{
+}
+
+template <typename View, typename F>
+View view_cache::get(F&& build) const
+{
+    if (const auto cached = find<View>())
+    {
+        return *cached;
+    }
+
+    const auto view = std::make_shared<const View>(build());
+    add(type_id_v<View>, view);
+
+    return *view;
+}
+
+template <typename View, typename F>
+setting_result<View> view_cache::try_get(F&& build) const
+{
+    if (const auto cached = find<View>())
+    {
+        return View(*cached);
+    }
+
+    auto result = build();
+    if (!result)
+    {
+        return result.error();
+    }
+
+    const auto view = std::make_shared<const View>(std::move(result).value());
+    add(type_id_v<View>, view);
+
+    return View(*view);
+}
+
+template <typename View>
+std::shared_ptr<const View> view_cache::find() const
+{
+    const auto views = m_views.load();
+    const auto viewIt = views->find(type_id_v<View>);
+    if (viewIt == views->end())
+    {
+        return nullptr;
+    }
+
+    return std::static_pointer_cast<const View>(viewIt->second);
+}
+
+inline void view_cache::add(const void* key, std::shared_ptr<const void> view) const
+{
+    m_views.update([key, &view](const std::shared_ptr<const views_t>& cached) {
+        auto next = std::make_shared<views_t>(*cached);
+        // emplace keeps the view of a concurrent call that was faster, both are built from the same snapshot
+        next->emplace(key, view);
+        return std::shared_ptr<const views_t>(std::move(next));
+    });
+}
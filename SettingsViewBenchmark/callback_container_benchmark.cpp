@@ -0,0 +1,134 @@
+#include "pch.h"
+
+#include <callback_container.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using callback_container_t = callback_container<std::function<void(int)>>;
+
+    // registers count callbacks adding the argument to the sum
+    std::vector<callback_container_t::token_t> register_callbacks(callback_container_t& callbacks, std::size_t count, int& sum)
+    {
+        std::vector<callback_container_t::token_t> tokens;
+        tokens.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            tokens.push_back(callbacks.register_callback([&sum](int value) { sum += value; }));
+        }
+
+        return tokens;
+    }
+}  // namespace
+
+static void BM_CallbackContainerInvoke(benchmark::State& state)
+{
+    auto callbacks = callback_container_t::create_callback_container();
+    auto sum = 0;
+    const auto tokens = register_callbacks(*callbacks, static_cast<std::size_t>(state.range(0)), sum);
+
+    for (auto _ : state)
+    {
+        (*callbacks)(1);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CallbackContainerInvoke)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Concurrent dispatch from several threads, the callbacks do not share any state
+static void BM_CallbackContainerInvokeConcurrent(benchmark::State& state)
+{
+    static std::shared_ptr<callback_container_t> callbacks;
+    static std::vector<callback_container_t::token_t> tokens;
+    if (state.thread_index() == 0)
+    {
+        callbacks = callback_container_t::create_callback_container();
+        for (auto i = 0; i < state.range(0); ++i)
+        {
+            tokens.push_back(callbacks->register_callback([](int value) { benchmark::DoNotOptimize(value); }));
+        }
+    }
+
+    for (auto _ : state)
+    {
+        (*callbacks)(1);
+    }
+
+    if (state.thread_index() == 0)
+    {
+        tokens.clear();
+        callbacks.reset();
+    }
+}
+BENCHMARK(BM_CallbackContainerInvokeConcurrent)->Arg(10)->Arg(1000)->ThreadRange(1, 8)->UseRealTime();
+
+// Registration and unregistration of one callback beside range(0) registered ones
+static void BM_CallbackContainerRegisterUnregister(benchmark::State& state)
+{
+    auto callbacks = callback_container_t::create_callback_container();
+    auto sum = 0;
+    const auto tokens = register_callbacks(*callbacks, static_cast<std::size_t>(state.range(0)), sum);
+
+    for (auto _ : state)
+    {
+        auto token = callbacks->register_callback([&sum](int value) { sum += value; });
+        token.unregister();
+    }
+}
+BENCHMARK(BM_CallbackContainerRegisterUnregister)->Arg(0)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Registration churn while another thread dispatches continuously
+static void BM_CallbackContainerRegisterUnregisterDuringInvoke(benchmark::State& state)
+{
+    auto callbacks = callback_container_t::create_callback_container();
+    auto sum = 0;
+    const auto tokens = register_callbacks(*callbacks, static_cast<std::size_t>(state.range(0)), sum);
+
+    std::atomic<bool> done{false};
+    std::thread dispatcher([&]() {
+        while (!done)
+        {
+            (*callbacks)(0);
+        }
+    });
+
+    for (auto _ : state)
+    {
+        auto token = callbacks->register_callback([&sum](int value) { sum += value; });
+        token.unregister();
+    }
+
+    done = true;
+    dispatcher.join();
+}
+BENCHMARK(BM_CallbackContainerRegisterUnregisterDuringInvoke)->Arg(10)->Arg(1000)->UseRealTime();
+
+// The caller's cost of the asynchronous dispatch, the callbacks run on the executor
+static void BM_CallbackContainerInvokeAsync(benchmark::State& state)
+{
+    const auto policy = static_cast<bounded_executor::overflow_policy>(state.range(1));
+    const auto executor = std::make_shared<bounded_executor>(1, 1024, policy);
+    auto callbacks = callback_container_t::create_callback_container(executor);
+    auto sum = 0;
+    const auto tokens = register_callbacks(*callbacks, static_cast<std::size_t>(state.range(0)), sum);
+
+    for (auto _ : state)
+    {
+        (*callbacks)(1);
+    }
+
+    executor->wait_idle();
+    benchmark::DoNotOptimize(sum);
+    state.counters["discarded"] = static_cast<double>(executor->discarded());
+}
+BENCHMARK(BM_CallbackContainerInvokeAsync)
+    ->ArgsProduct({{10, 1000},
+                   {static_cast<int>(bounded_executor::overflow_policy::drop_oldest),
+                    static_cast<int>(bounded_executor::overflow_policy::coalesce)}})
+    ->ArgNames({"callbacks", "policy"});
@@ -0,0 +1,98 @@
+#include "pch.h"
+
+#include <json_settings_loader.h>
+#include <json_settings_reader.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t filesCount = 12;
+    constexpr std::size_t membersPerFile = 50000;
+
+    // filesCount files of { "member0" : 0, "name0" : "value 0", ... }, about 2 MiB each
+    class settings_files final
+    {
+    public:
+        settings_files()
+        {
+            for (std::size_t file = 0; file < filesCount; ++file)
+            {
+                m_fileNames.push_back((std::filesystem::temp_directory_path() / ("settings_source_" + std::to_string(file) + ".json")).string());
+
+                std::ofstream output(m_fileNames.back(), std::ios::binary | std::ios::trunc);
+                output << "{";
+                for (std::size_t i = 0; i < membersPerFile; ++i)
+                {
+                    const auto index = std::to_string(i);
+                    output << (i == 0 ? "\"member" : ", \"member") << index << "\" : " << index << ", \"name" << index << "\" : \"value " << index << "\"";
+                }
+                output << "}";
+            }
+        }
+
+        settings_files(const settings_files&) = delete;
+        settings_files& operator=(const settings_files&) = delete;
+
+        ~settings_files()
+        {
+            for (const auto& fileName : m_fileNames)
+            {
+                std::remove(fileName.c_str());
+            }
+        }
+
+        const std::vector<std::string>& file_names() const noexcept
+        {
+            return m_fileNames;
+        }
+
+    private:
+        std::vector<std::string> m_fileNames;
+    };
+
+    //! The files are generated once and removed at exit
+    const std::vector<std::string>& settings_file_names()
+    {
+        static const settings_files files;
+        return files.file_names();
+    }
+}  // namespace
+
+// The baseline, the files are parsed one after another on the calling thread
+static void BM_JsonSettingsReaderLoadSerial(benchmark::State& state)
+{
+    const auto& fileNames = settings_file_names();
+
+    for (auto _ : state)
+    {
+        std::vector<std::unique_ptr<json_settings_reader>> readers;
+        for (const auto& fileName : fileNames)
+        {
+            readers.push_back(std::make_unique<json_settings_reader>(fileName));
+        }
+        benchmark::DoNotOptimize(readers.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * fileNames.size()));
+}
+BENCHMARK(BM_JsonSettingsReaderLoadSerial)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The argument is the count of the threads of the loader
+static void BM_JsonSettingsLoaderLoad(benchmark::State& state)
+{
+    const auto& fileNames = settings_file_names();
+    const json_settings_loader loader(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        const auto readers = loader.load(fileNames);
+        benchmark::DoNotOptimize(readers.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * fileNames.size()));
+}
+BENCHMARK(BM_JsonSettingsLoaderLoad)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
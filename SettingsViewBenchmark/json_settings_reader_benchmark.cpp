@@ -0,0 +1,218 @@
+#include "pch.h"
+
+#include <json_settings_reader.h>
+#include <settings_path.h>
+
+#include <rapidjson/document.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // { "member0" : 0, "member1" : 1, ... }
+    std::string make_flat_settings(std::size_t membersCount)
+    {
+        std::string json{"{"};
+        for (std::size_t i = 0; i < membersCount; ++i)
+        {
+            json += (i == 0 ? "\"member" : ", \"member") + std::to_string(i) + "\" : " + std::to_string(i);
+        }
+        json += "}";
+
+        return json;
+    }
+
+    // { "member0" : 0, ..., "nested" : { "member0" : 0, ..., "nested" : { ... "value" : 42 } } }
+    // each object has siblingsCount members beside the nested one, the "value" is at depth
+    std::string make_nested_settings(std::size_t depth, std::size_t siblingsCount)
+    {
+        std::string json;
+        for (std::size_t level = 1; level <= depth; ++level)
+        {
+            json += "{";
+            for (std::size_t i = 0; i < siblingsCount; ++i)
+            {
+                json += "\"member" + std::to_string(i) + "\" : " + std::to_string(i) + ", ";
+            }
+            json += level == depth ? "\"value\" : 42" : "\"nested\" : ";
+        }
+        json += std::string(depth, '}');
+
+        return json;
+    }
+
+    // "nested/nested/.../value"
+    std::string make_nested_path(std::size_t depth)
+    {
+        std::string path;
+        for (std::size_t level = 1; level < depth; ++level)
+        {
+            path += "nested/";
+        }
+
+        return path + "value";
+    }
+
+    constexpr std::size_t nestedSiblingsCount = 64;
+
+    std::vector<std::string> make_member_names(std::size_t membersCount)
+    {
+        std::vector<std::string> names;
+        names.reserve(membersCount);
+        for (std::size_t i = 0; i < membersCount; ++i)
+        {
+            names.push_back("member" + std::to_string(i));
+        }
+
+        return names;
+    }
+}  // namespace
+
+// The lookup used by json_settings_reader before the member index was introduced
+static void BM_DocumentFindMember(benchmark::State& state)
+{
+    const auto membersCount = static_cast<std::size_t>(state.range(0));
+    const auto names = make_member_names(membersCount);
+    rapidjson::Document settings;
+    settings.Parse(make_flat_settings(membersCount).c_str());
+
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto valueIt = settings.FindMember(names[i].c_str());
+        benchmark::DoNotOptimize(valueIt->value.GetInt());
+        i = (i + 1) % membersCount;
+    }
+}
+BENCHMARK(BM_DocumentFindMember)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+static void BM_JsonSettingsReaderGetInt(benchmark::State& state)
+{
+    const auto membersCount = static_cast<std::size_t>(state.range(0));
+    const auto names = make_member_names(membersCount);
+    rapidjson::Document settings;
+    settings.Parse(make_flat_settings(membersCount).c_str());
+    const json_settings_reader reader(std::move(settings));
+    const std::vector<settings_path> paths(names.begin(), names.end());
+
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        int value{};
+        reader.get(value, paths[i]);
+        benchmark::DoNotOptimize(value);
+        i = (i + 1) % membersCount;
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderGetInt)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+// Probing a missing setting, the error message is built and thrown
+static void BM_JsonSettingsReaderGetMissing(benchmark::State& state)
+{
+    rapidjson::Document settings;
+    settings.Parse(make_flat_settings(64).c_str());
+    const json_settings_reader reader(std::move(settings));
+    const settings_path path{"missing"};
+
+    for (auto _ : state)
+    {
+        int value{};
+        try
+        {
+            reader.get(value, path);
+        }
+        catch (const std::runtime_error& ex)
+        {
+            benchmark::DoNotOptimize(ex.what());
+        }
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderGetMissing);
+
+// As BM_JsonSettingsReaderGetMissing, the failure is returned as a code
+static void BM_JsonSettingsReaderTryGetMissing(benchmark::State& state)
+{
+    rapidjson::Document settings;
+    settings.Parse(make_flat_settings(64).c_str());
+    const json_settings_reader reader(std::move(settings));
+    const settings_path path{"missing"};
+
+    for (auto _ : state)
+    {
+        int value{};
+        const auto result = reader.try_get(value, path);
+        benchmark::DoNotOptimize(result.error().code);
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderTryGetMissing);
+
+static void BM_JsonSettingsReaderConstruction(benchmark::State& state)
+{
+    const auto json = make_flat_settings(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        rapidjson::Document settings;
+        settings.Parse(json.c_str());
+        const json_settings_reader reader(std::move(settings));
+        benchmark::DoNotOptimize(&reader);
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderConstruction)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+// Member lookup by member lookup without any index
+static void BM_DocumentFindMemberNested(benchmark::State& state)
+{
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    rapidjson::Document settings;
+    settings.Parse(make_nested_settings(depth, nestedSiblingsCount).c_str());
+
+    for (auto _ : state)
+    {
+        const rapidjson::Value* value = &settings;
+        for (std::size_t level = 1; level < depth; ++level)
+        {
+            value = &value->FindMember("nested")->value;
+        }
+        benchmark::DoNotOptimize(value->FindMember("value")->value.GetInt());
+    }
+}
+BENCHMARK(BM_DocumentFindMemberNested)->DenseRange(1, 8);
+
+// The path is tokenized once, as compiled_path<T>() does for the setting types
+static void BM_JsonSettingsReaderGetNested(benchmark::State& state)
+{
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    rapidjson::Document settings;
+    settings.Parse(make_nested_settings(depth, nestedSiblingsCount).c_str());
+    const json_settings_reader reader(std::move(settings));
+    const settings_path path{make_nested_path(depth)};
+
+    for (auto _ : state)
+    {
+        int value{};
+        reader.get(value, path);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderGetNested)->DenseRange(1, 8);
+
+// The path is tokenized with each call
+static void BM_JsonSettingsReaderGetNestedFromString(benchmark::State& state)
+{
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    rapidjson::Document settings;
+    settings.Parse(make_nested_settings(depth, nestedSiblingsCount).c_str());
+    const json_settings_reader reader(std::move(settings));
+    const auto path = make_nested_path(depth);
+
+    for (auto _ : state)
+    {
+        int value{};
+        reader.get(value, path.c_str());
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_JsonSettingsReaderGetNestedFromString)->DenseRange(1, 8);
@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include <monitor.h>
+#include <seqlock.h>
+#include <sharded_shared_mutex.h>
+
+#include <array>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+
+namespace
+{
+    // a value larger than a word, i.e. a torn read would be possible without the monitor
+    using value_t = std::array<int, 8>;
+
+    int sum(const value_t& value)
+    {
+        return std::accumulate(value.begin(), value.end(), 0);
+    }
+
+    int sum(int value)
+    {
+        return value;
+    }
+
+    void increment(value_t& value)
+    {
+        for (auto& item : value)
+        {
+            ++item;
+        }
+    }
+
+    void increment(int& value)
+    {
+        ++value;
+    }
+}  // namespace
+
+// Readers only, the const callback takes the shared lock (or none with the seqlock)
+template <typename Mtx, typename T = value_t>
+static void BM_MonitorShared(benchmark::State& state)
+{
+    static monitor<T, Mtx> value;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value([](const T& v) { return sum(v); }));
+    }
+}
+BENCHMARK_TEMPLATE(BM_MonitorShared, std::shared_mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorShared, std::mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorShared, seqlock)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorShared, sharded_shared_mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorShared, std::shared_mutex, int)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorShared, seqlock, int)->ThreadRange(1, 16)->UseRealTime();
+
+// Writers only, the non-const callback takes the exclusive lock
+template <typename Mtx, typename T = value_t>
+static void BM_MonitorExclusive(benchmark::State& state)
+{
+    static monitor<T, Mtx> value;
+
+    for (auto _ : state)
+    {
+        value([](T& v) { increment(v); });
+    }
+}
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, std::shared_mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, std::mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, seqlock)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, sharded_shared_mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, std::shared_mutex, int)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorExclusive, seqlock, int)->ThreadRange(1, 16)->UseRealTime();
+
+// The first thread writes, all the others read, i.e. the typical settings access pattern
+template <typename Mtx, typename T = value_t>
+static void BM_MonitorSharedWithWriter(benchmark::State& state)
+{
+    static monitor<T, Mtx> value;
+
+    if (state.thread_index() == 0)
+    {
+        for (auto _ : state)
+        {
+            value([](T& v) { increment(v); });
+        }
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value([](const T& v) { return sum(v); }));
+    }
+}
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, std::shared_mutex)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, std::mutex)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, seqlock)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, sharded_shared_mutex)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, std::shared_mutex, int)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MonitorSharedWithWriter, seqlock, int)->ThreadRange(2, 16)->UseRealTime();
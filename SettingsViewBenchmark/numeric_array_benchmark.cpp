@@ -0,0 +1,210 @@
+#include "pch.h"
+
+#include <binary_settings_compiler.h>
+#include <binary_settings_reader.h>
+#include <json_settings_reader.h>
+#include <numeric_array.h>
+#include <streaming_json_settings_reader.h>
+
+#include <rapidjson/document.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // { "weights" : [ -size, ..., size - 1 ] } of integers (i.e. int64 array) spread over more than the int range
+    std::string make_array_settings(std::size_t size)
+    {
+        std::string json{"{\"weights\" : ["};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            json += (i == 0 ? "" : ", ") + std::to_string((static_cast<std::int64_t>(i) - static_cast<std::int64_t>(size)) * 4099);
+        }
+        json += "]}";
+
+        return json;
+    }
+
+    rapidjson::Document parse(const std::string& json)
+    {
+        rapidjson::Document document;
+        document.Parse(json.c_str());
+        return document;
+    }
+
+    //! The make_array_settings as JSON or compiled to the binary image in a temporary file, removed at exit
+    class array_settings_file final
+    {
+    public:
+        array_settings_file(std::size_t size, bool compiled)
+            : m_path{(std::filesystem::temp_directory_path() / ("array_settings_" + std::to_string(size) + (compiled ? ".svbin" : ".json"))).string()}
+        {
+            const auto json = make_array_settings(size);
+            const auto content = compiled ? compile_binary_settings(parse(json)) : json;
+            std::ofstream(m_path, std::ios::binary | std::ios::trunc).write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+
+        array_settings_file(const array_settings_file&) = delete;
+        array_settings_file& operator=(const array_settings_file&) = delete;
+
+        ~array_settings_file()
+        {
+            std::remove(m_path.c_str());
+        }
+
+        const std::string& path() const noexcept
+        {
+            return m_path;
+        }
+
+    private:
+        std::string m_path;
+    };
+
+    const array_settings_file& array_file(std::size_t size, bool compiled = true)
+    {
+        static std::map<std::pair<std::size_t, bool>, std::unique_ptr<array_settings_file>> files;
+
+        auto& file = files[{size, compiled}];
+        if (!file)
+        {
+            file = std::make_unique<array_settings_file>(size, compiled);
+        }
+
+        return *file;
+    }
+
+    std::vector<std::int64_t> make_integers(std::size_t size)
+    {
+        std::vector<std::int64_t> integers(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            integers[i] = (static_cast<std::int64_t>(i) - static_cast<std::int64_t>(size)) * 4099;
+        }
+
+        return integers;
+    }
+}  // namespace
+
+// The baseline, element by element through the rapidjson::Value accessors to a std::vector
+static void BM_DocumentArrayElementwise(benchmark::State& state)
+{
+    const auto document = parse(make_array_settings(static_cast<std::size_t>(state.range(0))));
+    const auto& weights = document["weights"];
+
+    for (auto _ : state)
+    {
+        std::vector<double> values;
+        for (auto itemIt = weights.Begin(); itemIt != weights.End(); ++itemIt)
+        {
+            values.push_back(itemIt->GetDouble());
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DocumentArrayElementwise)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+static void BM_JsonSettingsReaderGetArray(benchmark::State& state)
+{
+    const json_settings_reader reader(parse(make_array_settings(static_cast<std::size_t>(state.range(0)))));
+    const settings_path path{"weights"};
+
+    for (auto _ : state)
+    {
+        numeric_array<double> values;
+        reader.get(values, path);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JsonSettingsReaderGetArray)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// The items are stored contiguously in the image, i.e. the reader converts them by convert_numbers
+static void BM_BinarySettingsReaderGetArray(benchmark::State& state)
+{
+    const binary_settings_reader reader(array_file(static_cast<std::size_t>(state.range(0))).path());
+    const settings_path path{"weights"};
+
+    for (auto _ : state)
+    {
+        numeric_array<double> values;
+        reader.get(values, path);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinarySettingsReaderGetArray)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// The same type, a plain copy
+static void BM_BinarySettingsReaderGetInt64Array(benchmark::State& state)
+{
+    const binary_settings_reader reader(array_file(static_cast<std::size_t>(state.range(0))).path());
+    const settings_path path{"weights"};
+
+    for (auto _ : state)
+    {
+        numeric_array<std::int64_t> values;
+        reader.get(values, path);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinarySettingsReaderGetInt64Array)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// The items are collected to a contiguous std::int64_t buffer while the file is parsed, i.e. converted by convert_numbers
+static void BM_StreamingJsonSettingsReaderGetArray(benchmark::State& state)
+{
+    const settings_path path{"weights"};
+    const streaming_json_settings_reader reader(array_file(static_cast<std::size_t>(state.range(0)), false).path(), {path});
+
+    for (auto _ : state)
+    {
+        numeric_array<double> values;
+        reader.get(values, path);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamingJsonSettingsReaderGetArray)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+static void BM_ConvertNumbersScalar(benchmark::State& state)
+{
+    const auto source = make_integers(static_cast<std::size_t>(state.range(0)));
+    numeric_array<double> destination(source.size());
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            destination.data()[i] = static_cast<double>(source[i]);
+        }
+        benchmark::DoNotOptimize(destination.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertNumbersScalar)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+static void BM_ConvertNumbers(benchmark::State& state)
+{
+    const auto source = make_integers(static_cast<std::size_t>(state.range(0)));
+    numeric_array<double> destination(source.size());
+
+    for (auto _ : state)
+    {
+        convert_numbers(source.data(), source.size(), destination.data());
+        benchmark::DoNotOptimize(destination.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertNumbers)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
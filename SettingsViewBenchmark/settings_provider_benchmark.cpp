@@ -0,0 +1,323 @@
+#include "pch.h"
+
+#include <settings_provider.h>
+#include <static_settings_provider.h>
+#include <validated_settings_provider.h>
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    constexpr const char* settingNames[] = {"setting0",  "setting1",  "setting2",  "setting3",  "setting4",  "setting5",  "setting6",
+                                            "setting7",  "setting8",  "setting9",  "setting10", "setting11", "setting12", "setting13",
+                                            "setting14", "setting15", "setting16", "setting17", "setting18", "setting19", "setting20",
+                                            "setting21", "setting22", "setting23", "setting24", "setting25", "setting26", "setting27",
+                                            "setting28", "setting29", "setting30", "setting31"};
+
+    // the N-th setting type, all of them int
+    template <std::size_t N>
+    struct int_setting
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = settingNames[N];
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    // In-memory reader, measures the provider rather than the settings backend
+    class map_settings_reader final : public settings_reader
+    {
+    public:
+        map_settings_reader()
+        {
+            for (std::size_t i = 0; i < std::size(settingNames); ++i)
+            {
+                m_values.emplace(settingNames[i], static_cast<int>(i));
+            }
+        }
+
+        void get(int& value, const settings_path& path) const override
+        {
+            value = m_values.at(path.key());
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(const setting_request* requests, std::size_t count) const override
+        {
+            for (auto request = requests; request != requests + count; ++request)
+            {
+                *std::get<int*>(request->destination) = m_values.at(request->path->key());
+            }
+        }
+
+    private:
+        std::unordered_map<std::string, int> m_values;
+    };
+
+    template <typename Sequence>
+    struct int_settings;
+
+    template <std::size_t... I>
+    struct int_settings<std::index_sequence<I...>>
+    {
+        static auto get_view(settings_provider& provider)
+        {
+            return provider.get_view<int_setting<I>...>("benchmark");
+        }
+
+        static auto get_view(const static_settings_provider<map_settings_reader>& provider)
+        {
+            return provider.get_view<int_setting<I>...>();
+        }
+
+        template <typename Provider>
+        static auto get_validated_view(const Provider& provider)
+        {
+            return provider.template get_view<int_setting<I>...>();
+        }
+
+        using validated_provider_t = validated_settings_provider<int_setting<I>...>;
+    };
+
+    template <std::size_t N>
+    using int_settings_t = int_settings<std::make_index_sequence<N>>;
+
+    // validates all the settings of the map_settings_reader
+    using all_int_settings_provider_t = int_settings_t<std::size(settingNames)>::validated_provider_t;
+
+    // the N-th setting type with a costly parse, e.g. building a lookup table
+    template <std::size_t N>
+    struct table_setting
+    {
+        using source_type = int;
+        using value_type = std::vector<int>;
+
+        static constexpr auto path = settingNames[N];
+
+        static value_type parse(source_type&& input)
+        {
+            value_type table(4096);
+            for (std::size_t i = 0; i < table.size(); ++i)
+            {
+                table[i] = input * static_cast<int>(i) % 977;
+            }
+            return table;
+        }
+    };
+
+    template <typename Sequence>
+    struct table_settings;
+
+    template <std::size_t... I>
+    struct table_settings<std::index_sequence<I...>>
+    {
+        static auto get_view(settings_provider& provider)
+        {
+            return provider.get_view<table_setting<I>...>("benchmark");
+        }
+
+        static auto get_lazy_view(settings_provider& provider)
+        {
+            return provider.get_lazy_view<table_setting<I>...>("benchmark");
+        }
+    };
+
+    template <std::size_t N>
+    using table_settings_t = table_settings<std::make_index_sequence<N>>;
+}  // namespace
+
+// The view of the current generation is cached, i.e. the observers notification and the cache lookup
+template <std::size_t N>
+static void BM_SettingsProviderGetView(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 2);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 4);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 16);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 32);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetView, 8)->ThreadRange(1, 8)->UseRealTime();
+
+// As BM_SettingsProviderGetView with a registered observer, the setting descriptors are passed without any allocation
+template <std::size_t N>
+static void BM_SettingsProviderGetViewObserved(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+    std::size_t requested = 0;
+    auto token = provider.add_observer([&requested](const std::string&, setting_descriptors descriptors) { requested += descriptors.size(); });
+
+    for (auto _ : state)
+    {
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+    benchmark::DoNotOptimize(requested);
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewObserved, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewObserved, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewObserved, 32);
+
+// As BM_SettingsProviderGetView with the telemetry recording each call
+template <std::size_t N>
+static void BM_SettingsProviderGetViewTelemetry(benchmark::State& state)
+{
+    static const auto telemetry = std::make_shared<settings_telemetry>();
+    settings_provider provider(std::make_unique<map_settings_reader>(), nullptr, telemetry);
+
+    for (auto _ : state)
+    {
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewTelemetry, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewTelemetry, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewTelemetry, 8)->ThreadRange(1, 8)->UseRealTime();
+
+// Each view is built from the reader, the reload publishing a new snapshot is measured as well
+template <std::size_t N>
+static void BM_SettingsProviderGetViewAfterReload(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        provider.reload(std::make_unique<map_settings_reader>());
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewAfterReload, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewAfterReload, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewAfterReload, 32);
+
+// As BM_SettingsProviderGetView, the reader is called without the virtual dispatch
+// The cached view is not read, i.e. no difference from BM_SettingsProviderGetView is expected
+template <std::size_t N>
+static void BM_StaticSettingsProviderGetView(benchmark::State& state)
+{
+    static_settings_provider<map_settings_reader> provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetView, 1);
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetView, 8);
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetView, 32);
+
+// As BM_SettingsProviderGetViewAfterReload, the reader is called without the virtual dispatch
+template <std::size_t N>
+static void BM_StaticSettingsProviderGetViewAfterReload(benchmark::State& state)
+{
+    static_settings_provider<map_settings_reader> provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        provider.reload(std::make_unique<map_settings_reader>());
+        const auto view = int_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetViewAfterReload, 1);
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetViewAfterReload, 8);
+BENCHMARK_TEMPLATE(BM_StaticSettingsProviderGetViewAfterReload, 32);
+
+// As BM_SettingsProviderGetView, the view aliases the values validated at load, i.e. no lookup or allocation
+template <std::size_t N>
+static void BM_ValidatedSettingsProviderGetView(benchmark::State& state)
+{
+    const all_int_settings_provider_t provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        const auto view = int_settings_t<N>::get_validated_view(provider);
+        benchmark::DoNotOptimize(view.template get<int_setting<N - 1>>());
+    }
+}
+BENCHMARK_TEMPLATE(BM_ValidatedSettingsProviderGetView, 1);
+BENCHMARK_TEMPLATE(BM_ValidatedSettingsProviderGetView, 8);
+BENCHMARK_TEMPLATE(BM_ValidatedSettingsProviderGetView, 32);
+BENCHMARK_TEMPLATE(BM_ValidatedSettingsProviderGetView, 8)->ThreadRange(1, 8)->UseRealTime();
+
+// Each view is built after a reload and only one of its N costly settings is used, all of them are parsed
+template <std::size_t N>
+static void BM_SettingsProviderGetViewSparseAccess(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        provider.reload(std::make_unique<map_settings_reader>());
+        const auto view = table_settings_t<N>::get_view(provider);
+        benchmark::DoNotOptimize(view.template get<table_setting<0>>().data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewSparseAccess, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewSparseAccess, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetViewSparseAccess, 32);
+
+// As BM_SettingsProviderGetViewSparseAccess with the lazy view, only the used setting is parsed
+template <std::size_t N>
+static void BM_SettingsProviderGetLazyViewSparseAccess(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        provider.reload(std::make_unique<map_settings_reader>());
+        const auto view = table_settings_t<N>::get_lazy_view(provider);
+        benchmark::DoNotOptimize(view.template get<table_setting<0>>().data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyViewSparseAccess, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyViewSparseAccess, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyViewSparseAccess, 32);
+
+// The lazy view of the current generation is cached and its setting already parsed, i.e. the cost of the lazy get
+template <std::size_t N>
+static void BM_SettingsProviderGetLazyView(benchmark::State& state)
+{
+    settings_provider provider(std::make_unique<map_settings_reader>());
+
+    for (auto _ : state)
+    {
+        const auto view = table_settings_t<N>::get_lazy_view(provider);
+        benchmark::DoNotOptimize(view.template get<table_setting<N - 1>>().data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyView, 1);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyView, 8);
+BENCHMARK_TEMPLATE(BM_SettingsProviderGetLazyView, 32);
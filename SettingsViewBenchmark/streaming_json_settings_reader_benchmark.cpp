@@ -0,0 +1,235 @@
+#include "pch.h"
+
+#include <json_settings_reader.h>
+#include <settings_path.h>
+#include <streaming_json_settings_reader.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t membersPerGroup = 100;
+    //! every groupsStride-th group is read, i.e. 1% of the settings
+    constexpr std::size_t groupsStride = 100;
+
+    //! Resident set size of the process in bytes
+    struct memory_usage final
+    {
+        std::int64_t resident;
+        //! the highest resident since the process start or since the last reset_peak_resident
+        std::int64_t peak;
+    };
+
+    memory_usage current_memory_usage()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return {static_cast<std::int64_t>(counters.WorkingSetSize), static_cast<std::int64_t>(counters.PeakWorkingSetSize)};
+#else
+        memory_usage usage{0, 0};
+        // the lines are e.g. "VmRSS:\t    1234 kB"
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            long long kiB = 0;
+            if (std::sscanf(line.c_str(), "VmRSS: %lld", &kiB) == 1)
+            {
+                usage.resident = kiB * 1024;
+            }
+            else if (std::sscanf(line.c_str(), "VmHWM: %lld", &kiB) == 1)
+            {
+                usage.peak = kiB * 1024;
+            }
+        }
+        return usage;
+#endif
+    }
+
+    //! Sets the peak resident set size to the current one
+    //! \returns false if not supported, i.e. the peak is the highest since the process start (always on Windows)
+    bool reset_peak_resident()
+    {
+#ifdef _WIN32
+        return false;
+#else
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.flush();
+        return clearRefs.good();
+#endif
+    }
+
+    //! Measures the memory of an iteration (excluded from its time)
+    //! peak_MiB is the highest growth of the resident set size during the iteration, retained_MiB the growth at its end.
+    //! Both are signed, the resident set may shrink (e.g. the pages of the previous iteration are returned to the system),
+    //! and the heap pages kept resident by the previous iterations are not counted.
+    class memory_probe final
+    {
+    public:
+        explicit memory_probe(benchmark::State& state)
+            : m_state{state}
+        {
+            m_state.PauseTiming();
+            m_peakReset = reset_peak_resident();
+            m_before = current_memory_usage();
+            m_state.ResumeTiming();
+        }
+
+        //! Call before the measured memory is released
+        void record()
+        {
+            m_state.PauseTiming();
+            const auto after = current_memory_usage();
+            constexpr double mebibyte = 1024 * 1024;
+            m_state.counters["retained_MiB"] = static_cast<double>(after.resident - m_before.resident) / mebibyte;
+            // without the reset the peak may be an older one, not related to the iteration
+            m_state.counters["peak_MiB"] = m_peakReset ? static_cast<double>(after.peak - m_before.resident) / mebibyte : 0.0;
+            m_state.ResumeTiming();
+        }
+
+    private:
+        benchmark::State& m_state;
+        bool m_peakReset;
+        memory_usage m_before;
+    };
+
+    // { "group0" : { "member0" : 0, "name0" : "value 0", ... }, "group1" : ... } of about sizeMiB MiB
+    class large_settings_file final
+    {
+    public:
+        explicit large_settings_file(std::size_t sizeMiB)
+            : m_path{(std::filesystem::temp_directory_path() / ("settings_" + std::to_string(sizeMiB) + "MiB.json")).string()}
+            , m_size{0}
+            , m_groupsCount{0}
+        {
+            std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+            std::string group;
+            file << "{";
+            while (m_size < sizeMiB * 1024 * 1024)
+            {
+                group = (m_groupsCount == 0 ? "\"group" : ", \"group") + std::to_string(m_groupsCount) + "\" : {";
+                for (std::size_t i = 0; i < membersPerGroup; ++i)
+                {
+                    const auto index = std::to_string(i);
+                    group += (i == 0 ? "\"member" : ", \"member") + index + "\" : " + index + ", \"name" + index + "\" : \"value " + index + "\"";
+                }
+                group += "}";
+
+                file << group;
+                m_size += group.size();
+                ++m_groupsCount;
+            }
+            file << "}";
+        }
+
+        large_settings_file(const large_settings_file&) = delete;
+        large_settings_file& operator=(const large_settings_file&) = delete;
+
+        ~large_settings_file()
+        {
+            std::remove(m_path.c_str());
+        }
+
+        const std::string& path() const noexcept
+        {
+            return m_path;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        //! The int members of every groupsStride-th group
+        std::vector<settings_path> read_paths() const
+        {
+            std::vector<settings_path> paths;
+            for (auto group = groupsStride / 2; group < m_groupsCount; group += groupsStride)
+            {
+                for (std::size_t i = 0; i < membersPerGroup; ++i)
+                {
+                    paths.emplace_back("group" + std::to_string(group) + "/member" + std::to_string(i));
+                }
+            }
+
+            return paths;
+        }
+
+    private:
+        std::string m_path;
+        std::size_t m_size;
+        std::size_t m_groupsCount;
+    };
+
+    //! The file of each size is generated once and removed at exit
+    const large_settings_file& settings_file(std::size_t sizeMiB)
+    {
+        static std::map<std::size_t, std::unique_ptr<large_settings_file>> files;
+
+        auto& file = files[sizeMiB];
+        if (!file)
+        {
+            file = std::make_unique<large_settings_file>(sizeMiB);
+        }
+
+        return *file;
+    }
+}  // namespace
+
+// The whole document is parsed (in-situ in the mapped file) and indexed
+// peak_MiB is the highest memory used by the load, i.e. the touched pages of the file, the DOM and the index
+// (Linux only, the peak of Windows cannot be reset), retained_MiB the memory held by the loaded reader
+static void BM_JsonSettingsReaderLoadDom(benchmark::State& state)
+{
+    const auto& file = settings_file(static_cast<std::size_t>(state.range(0)));
+    const auto paths = file.read_paths();
+
+    for (auto _ : state)
+    {
+        memory_probe memory(state);
+        const json_settings_reader reader(file.path());
+        int value{};
+        reader.get(value, paths.back());
+        benchmark::DoNotOptimize(value);
+
+        memory.record();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * file.size()));
+}
+BENCHMARK(BM_JsonSettingsReaderLoadDom)->Arg(1)->Arg(100)->Unit(benchmark::kMillisecond);
+
+// Only 1% of the settings are registered, the other groups are skipped
+static void BM_StreamingJsonSettingsReaderLoad(benchmark::State& state)
+{
+    const auto& file = settings_file(static_cast<std::size_t>(state.range(0)));
+    const auto paths = file.read_paths();
+
+    for (auto _ : state)
+    {
+        memory_probe memory(state);
+        const streaming_json_settings_reader reader(file.path(), paths);
+        int value{};
+        reader.get(value, paths.back());
+        benchmark::DoNotOptimize(value);
+
+        memory.record();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * file.size()));
+}
+BENCHMARK(BM_StreamingJsonSettingsReaderLoad)->Arg(1)->Arg(100)->Unit(benchmark::kMillisecond);
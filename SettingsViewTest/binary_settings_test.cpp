@@ -0,0 +1,350 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <binary_settings_compiler.h>
+#include <binary_settings_format.h>
+#include <binary_settings_reader.h>
+#include <json_settings_reader.h>
+
+#include <rapidjson/document.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    const char* const settingsJson = R"({
+        "name" : "Filip",
+        "age" : 37,
+        "big" : 10000000000,
+        "ratio" : 0.5,
+        "enabled" : true,
+        "address" : { "city" : "Brno", "zip" : 60200 },
+        "servers" : [ { "host" : "alpha" }, { "host" : "beta" } ],
+        "tiers" : [ 10, 20, 10000000000 ],
+        "weights" : [ 0.25, 1, 2.5 ],
+        "a/b" : { "c~d" : 1 },
+        "empty" : {}
+    })";
+
+    rapidjson::Document parse(const char* json)
+    {
+        rapidjson::Document document;
+        document.Parse(json);
+        return document;
+    }
+
+    binary_settings::header image_header(const std::string& image)
+    {
+        binary_settings::header header{};
+        std::memcpy(&header, image.data(), sizeof(header));
+        return header;
+    }
+
+    binary_settings::entry image_entry(const std::string& image, std::size_t index)
+    {
+        binary_settings::entry entry{};
+        std::memcpy(&entry, image.data() + sizeof(binary_settings::header) + index * sizeof(entry), sizeof(entry));
+        return entry;
+    }
+
+    void set_image_entry(std::string& image, std::size_t index, const binary_settings::entry& entry)
+    {
+        std::memcpy(&image[sizeof(binary_settings::header) + index * sizeof(entry)], &entry, sizeof(entry));
+    }
+}  // namespace
+
+TEST(BinarySettingsTest, RoundTripReadsTheSameValuesAsJson)
+{
+    const json_settings_reader jsonReader(parse(settingsJson));
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader binaryReader(file.path());
+
+    for (const auto* path : {"age", "address/zip", "a~1b/c~0d"})
+    {
+        int jsonValue = 0;
+        int binaryValue = 0;
+        jsonReader.get(jsonValue, path);
+        binaryReader.get(binaryValue, path);
+        ASSERT_EQ(jsonValue, binaryValue) << path;
+    }
+
+    for (const auto* path : {"name", "address/city", "servers/0/host", "/servers/1/host"})
+    {
+        std::string jsonValue;
+        std::string binaryValue;
+        jsonReader.get(jsonValue, path);
+        binaryReader.get(binaryValue, path);
+        ASSERT_EQ(jsonValue, binaryValue) << path;
+    }
+
+    for (const auto* path : {"age", "big", "tiers/2"})
+    {
+        std::int64_t jsonValue = 0;
+        std::int64_t binaryValue = 0;
+        jsonReader.get(jsonValue, path);
+        binaryReader.get(binaryValue, path);
+        ASSERT_EQ(jsonValue, binaryValue) << path;
+    }
+
+    for (const auto* path : {"age", "big", "ratio"})
+    {
+        double jsonValue = 0;
+        double binaryValue = 0;
+        jsonReader.get(jsonValue, path);
+        binaryReader.get(binaryValue, path);
+        ASSERT_EQ(jsonValue, binaryValue) << path;
+    }
+
+    bool enabled = false;
+    binaryReader.get(enabled, "enabled");
+    ASSERT_TRUE(enabled);
+}
+
+TEST(BinarySettingsTest, ArraysAreReadAsTheSameValuesAsJson)
+{
+    const json_settings_reader jsonReader(parse(settingsJson));
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader binaryReader(file.path());
+
+    for (const auto* path : {"tiers", "weights"})
+    {
+        numeric_array<double> jsonValue;
+        numeric_array<double> binaryValue;
+        jsonReader.get(jsonValue, path);
+        binaryReader.get(binaryValue, path);
+        ASSERT_EQ(jsonValue, binaryValue) << path;
+        ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(binaryValue.data()) % numeric_array<double>::alignment);
+    }
+
+    numeric_array<std::int64_t> jsonTiers;
+    numeric_array<std::int64_t> binaryTiers;
+    jsonReader.get(jsonTiers, "tiers");
+    binaryReader.get(binaryTiers, "tiers");
+    ASSERT_EQ((numeric_array<std::int64_t>{10, 20, 10000000000}), jsonTiers);
+    ASSERT_EQ(jsonTiers, binaryTiers);
+
+    // the real numbers are not integers and the items of the objects are not numbers
+    for (const settings_reader* reader : {static_cast<const settings_reader*>(&jsonReader), static_cast<const settings_reader*>(&binaryReader)})
+    {
+        numeric_array<std::int64_t> weights;
+        ASSERT_THROW(reader->get(weights, "weights"), std::runtime_error);
+        numeric_array<double> servers;
+        ASSERT_THROW(reader->get(servers, "servers"), std::runtime_error);
+    }
+}
+
+TEST(BinarySettingsTest, ForEachEnumeratesTheSameSettingsAsJson)
+{
+    const json_settings_reader jsonReader(parse(settingsJson));
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader binaryReader(file.path());
+
+    using settings_t = std::map<std::string, setting_value>;
+    settings_t jsonSettings;
+    settings_t binarySettings;
+    jsonReader.for_each([&jsonSettings](std::string_view key, const setting_value& value) { jsonSettings.emplace(key, value); });
+    binaryReader.for_each([&binarySettings](std::string_view key, const setting_value& value) { binarySettings.emplace(key, value); });
+
+    // the scalar values only, the keys are normalized and escaped
+    const settings_t expected{{"name", std::string_view{"Filip"}},
+                              {"age", 37},
+                              {"big", std::int64_t{10000000000}},
+                              {"ratio", 0.5},
+                              {"enabled", true},
+                              {"tiers/0", 10},
+                              {"tiers/1", 20},
+                              {"tiers/2", std::int64_t{10000000000}},
+                              {"weights/0", 0.25},
+                              {"weights/1", 1},
+                              {"weights/2", 2.5},
+                              {"address/city", std::string_view{"Brno"}},
+                              {"address/zip", 60200},
+                              {"servers/0/host", std::string_view{"alpha"}},
+                              {"servers/1/host", std::string_view{"beta"}},
+                              {"a~1b/c~0d", 1}};
+    ASSERT_EQ(expected, jsonSettings);
+    ASSERT_EQ(expected, binarySettings);
+}
+
+TEST(BinarySettingsTest, ForEachArrayEnumeratesTheArraysOfNumbers)
+{
+    const json_settings_reader jsonReader(parse(settingsJson));
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader binaryReader(file.path());
+
+    std::set<std::string> jsonArrays;
+    std::set<std::string> binaryArrays;
+    jsonReader.for_each_array([&jsonArrays](std::string_view key) { jsonArrays.emplace(key); });
+    binaryReader.for_each_array([&binaryArrays](std::string_view key) { binaryArrays.emplace(key); });
+
+    // the array of objects has no entry in the image
+    ASSERT_EQ((std::set<std::string>{"servers", "tiers", "weights"}), jsonArrays);
+    ASSERT_EQ((std::set<std::string>{"tiers", "weights"}), binaryArrays);
+}
+
+TEST(BinarySettingsTest, StringViewPointsToTheMappedFile)
+{
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader reader(file.path());
+
+    std::string_view first;
+    std::string_view second;
+    reader.get(first, "address/city");
+    reader.get(second, "address/city");
+
+    ASSERT_EQ("Brno", first);
+    ASSERT_EQ(first.data(), second.data());
+}
+
+TEST(BinarySettingsTest, BatchGetReportsAllErrors)
+{
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader reader(file.path());
+
+    const settings_path missing{"address/street"};
+    const settings_path notInt{"name"};
+    const settings_path notString{"big"};
+    const settings_path found{"age"};
+    int intValue = 0;
+    std::string stringValue;
+    const setting_request requests[] = {{&missing, &intValue}, {&notInt, &intValue}, {&notString, &stringValue}, {&found, &intValue}};
+
+    try
+    {
+        reader.get(requests, std::size(requests));
+        FAIL() << "std::runtime_error expected";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        ASSERT_EQ(
+            "Member 'address/street' not found\nMember 'name' is not of type int\nMember 'big' is not of type string", std::string(ex.what()));
+    }
+    ASSERT_EQ(37, intValue);
+}
+
+TEST(BinarySettingsTest, TryGetReturnsTheFailureCodes)
+{
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader reader(file.path());
+    const json_settings_reader jsonReader(parse(settingsJson));
+
+    const settings_path missing{"address/street"};
+    const settings_path notInt{"name"};
+    const settings_path found{"address/zip"};
+    int value = 0;
+
+    for (const settings_reader* current : {static_cast<const settings_reader*>(&reader), static_cast<const settings_reader*>(&jsonReader)})
+    {
+        ASSERT_EQ(setting_errc::not_found, current->try_get(value, missing).error().code);
+        ASSERT_EQ(&missing, current->try_get(value, missing).error().path);
+        ASSERT_EQ(setting_errc::type_mismatch, current->try_get(value, notInt).error().code);
+        ASSERT_TRUE(current->try_get(value, found).has_value());
+        ASSERT_EQ(60200, value);
+        value = 0;
+    }
+}
+
+TEST(BinarySettingsTest, OnlyLeafValuesAreCompiled)
+{
+    const temp_file file(compile_binary_settings(parse(settingsJson)));
+    const binary_settings_reader reader(file.path());
+
+    std::string value;
+    ASSERT_THROW(reader.get(value, "address"), std::runtime_error);
+    ASSERT_THROW(reader.get(value, "servers"), std::runtime_error);
+    ASSERT_THROW(reader.get(value, "empty"), std::runtime_error);
+}
+
+TEST(BinarySettingsTest, FirstOfDuplicateMembersIsCompiled)
+{
+    const temp_file file(compile_binary_settings(parse(R"({ "value" : 1, "value" : 2 })")));
+    const binary_settings_reader reader(file.path());
+
+    int value = 0;
+    reader.get(value, "value");
+
+    ASSERT_EQ(1, value);
+}
+
+TEST(BinarySettingsTest, CompilesJsonFile)
+{
+    const temp_file jsonFile(settingsJson, ".json");
+    const temp_file binaryFile("", ".bin");
+
+    compile_binary_settings(jsonFile.path(), binaryFile.path());
+    const binary_settings_reader reader(binaryFile.path());
+
+    std::string value;
+    reader.get(value, "servers/1/host");
+    ASSERT_EQ("beta", value);
+}
+
+TEST(BinarySettingsTest, RootMustBeObject)
+{
+    ASSERT_THROW(compile_binary_settings(parse("[1, 2]")), std::runtime_error);
+}
+
+TEST(BinarySettingsTest, InvalidImageThrows)
+{
+    const auto image = compile_binary_settings(parse(settingsJson));
+
+    const temp_file truncated(image.substr(0, image.size() - 1), ".truncated");
+    ASSERT_THROW(binary_settings_reader{truncated.path()}, std::runtime_error);
+
+    const temp_file json(settingsJson, ".json");
+    ASSERT_THROW(binary_settings_reader{json.path()}, std::runtime_error);
+}
+
+TEST(BinarySettingsTest, CorruptEntryIsReportedWhenAccessed)
+{
+    auto image = compile_binary_settings(parse(settingsJson));
+    const auto header = image_header(image);
+    for (std::size_t i = 0; i < header.entryCount; ++i)
+    {
+        auto entry = image_entry(image, i);
+        if (image.compare(header.stringsOffset + entry.keyOffset, entry.keyLength, "name") == 0)
+        {
+            entry.value = header.stringsSize;
+            set_image_entry(image, i, entry);
+        }
+    }
+    const temp_file file(image);
+
+    // the entries are not validated by the construction
+    const binary_settings_reader reader(file.path());
+
+    const settings_path name{"name"};
+    const settings_path age{"age"};
+    std::string nameValue;
+    int ageValue = 0;
+    ASSERT_EQ(setting_errc::unreadable, reader.try_get(nameValue, name).error().code);
+    ASSERT_THROW(reader.get(nameValue, name), std::runtime_error);
+    ASSERT_TRUE(reader.try_get(ageValue, age).has_value());
+    ASSERT_EQ(37, ageValue);
+    ASSERT_THROW(reader.for_each([](std::string_view, const setting_value&) {}), std::runtime_error);
+}
+
+TEST(BinarySettingsTest, MissInUnsortedImageIsReported)
+{
+    auto image = compile_binary_settings(parse(settingsJson));
+    const auto header = image_header(image);
+    const auto first = image_entry(image, 0);
+    const auto last = image_entry(image, header.entryCount - 1);
+    set_image_entry(image, 0, last);
+    set_image_entry(image, header.entryCount - 1, first);
+    const temp_file file(image);
+    const binary_settings_reader reader(file.path());
+
+    const settings_path missing{"address/street"};
+    int value = 0;
+    ASSERT_EQ(setting_errc::unreadable, reader.try_get(value, missing).error().code);
+}
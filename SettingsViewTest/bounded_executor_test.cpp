@@ -0,0 +1,144 @@
+#include "pch.h"
+
+#include <bounded_executor.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // occupies the single worker of the executor until released
+    class blocker final
+    {
+    public:
+        explicit blocker(bounded_executor& executor)
+        {
+            auto started = std::make_shared<std::promise<void>>();
+            auto startedFuture = started->get_future();
+            executor.post([started, release = m_release.get_future().share()]() {
+                started->set_value();
+                release.wait();
+            });
+            // the blocking task is running, i.e. it does not occupy the queue
+            startedFuture.wait();
+        }
+
+        void release()
+        {
+            m_release.set_value();
+        }
+
+    private:
+        std::promise<void> m_release;
+    };
+}  // namespace
+
+TEST(BoundedExecutorTest, ZeroThreadsOrCapacityThrows)
+{
+    using policy = bounded_executor::overflow_policy;
+    ASSERT_THROW(bounded_executor(0, 1, policy::block), std::invalid_argument);
+    ASSERT_THROW(bounded_executor(1, 0, policy::block), std::invalid_argument);
+}
+
+TEST(BoundedExecutorTest, AllPostedTasksRunInOrder)
+{
+    bounded_executor executor(1, 2, bounded_executor::overflow_policy::block);
+    std::vector<int> executed;
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        executor.post([&executed, i]() { executed.push_back(i); });
+    }
+    executor.wait_idle();
+
+    ASSERT_EQ(100, executed.size());
+    for (auto i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(i, executed[i]);
+    }
+    ASSERT_EQ(0, executor.discarded());
+}
+
+TEST(BoundedExecutorTest, DropOldestDiscardsPendingTasks)
+{
+    bounded_executor executor(1, 2, bounded_executor::overflow_policy::drop_oldest);
+    std::vector<int> executed;
+
+    blocker block(executor);
+    for (auto i = 0; i < 5; ++i)
+    {
+        executor.post([&executed, i]() { executed.push_back(i); });
+    }
+    block.release();
+    executor.wait_idle();
+
+    ASSERT_EQ((std::vector<int>{3, 4}), executed);
+    ASSERT_EQ(3, executor.discarded());
+}
+
+TEST(BoundedExecutorTest, CoalesceReplacesPendingTaskWithTheSameKey)
+{
+    bounded_executor executor(1, 4, bounded_executor::overflow_policy::coalesce);
+    std::vector<int> executed;
+    const int firstKey{};
+    const int secondKey{};
+
+    blocker block(executor);
+    executor.post([&executed]() { executed.push_back(1); }, &firstKey);
+    executor.post([&executed]() { executed.push_back(2); }, &secondKey);
+    executor.post([&executed]() { executed.push_back(3); }, &firstKey);
+    executor.post([&executed]() { executed.push_back(4); });
+    block.release();
+    executor.wait_idle();
+
+    // the replaced task keeps its position in the queue
+    ASSERT_EQ((std::vector<int>{3, 2, 4}), executed);
+    ASSERT_EQ(1, executor.discarded());
+}
+
+TEST(BoundedExecutorTest, BlockWaitsForFreeSpace)
+{
+    bounded_executor executor(1, 1, bounded_executor::overflow_policy::block);
+    std::atomic<int> executed{0};
+
+    blocker block(executor);
+    executor.post([&executed]() { executed++; });
+    auto posted = std::async(std::launch::async, [&]() { executor.post([&executed]() { executed++; }); });
+
+    ASSERT_EQ(std::future_status::timeout, posted.wait_for(std::chrono::milliseconds(50)));
+    block.release();
+    posted.get();
+    executor.wait_idle();
+
+    ASSERT_EQ(2, executed);
+}
+
+TEST(BoundedExecutorTest, DestructorRunsPendingTasks)
+{
+    std::atomic<int> executed{0};
+    {
+        bounded_executor executor(2, 100, bounded_executor::overflow_policy::block);
+        for (auto i = 0; i < 100; ++i)
+        {
+            executor.post([&executed]() { executed++; });
+        }
+    }
+
+    ASSERT_EQ(100, executed);
+}
+
+TEST(BoundedExecutorTest, ThrowingTaskDoesNotStopTheWorker)
+{
+    bounded_executor executor(1, 2, bounded_executor::overflow_policy::block);
+    auto executed = false;
+
+    executor.post([]() { throw std::runtime_error("failed"); });
+    executor.post([&executed]() { executed = true; });
+    executor.wait_idle();
+
+    ASSERT_TRUE(executed);
+}
@@ -3,10 +3,15 @@
 #include <callback_container.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST(CallbackContainerTest, FactoryCreatesNonemptyObject)
 {
@@ -150,6 +155,86 @@ TEST(CallbackContainerTest, UnregisteredCallbacksAreNotCalled)
     ASSERT_EQ(1, called[3]);
 }
 
+TEST(CallbackContainerTest, UnregisterWaitsForTheCallbackRunningOnAnotherThread)
+{
+    using container_t = callback_container<std::function<void(void)>>;
+
+    auto container = container_t::create_callback_container();
+    std::promise<void> called;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<bool> running{false};
+    auto token = container->register_callback([&]() {
+        running = true;
+        called.set_value();
+        released.wait();
+        running = false;
+    });
+
+    auto dispatch = std::async(std::launch::async, [&]() { (*container)(); });
+    called.get_future().wait();
+    auto releasing = std::async(std::launch::async, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.set_value();
+    });
+
+    token.unregister();
+
+    ASSERT_FALSE(running);
+    dispatch.get();
+    releasing.get();
+}
+
+TEST(CallbackContainerTest, UnregisterFinishesWhileOtherThreadsDispatchInTightLoop)
+{
+    using container_t = callback_container<std::function<void(void)>>;
+    static constexpr auto dispatchersCount = 4;
+    static constexpr auto registrationsCount = 10000;
+
+    auto container = container_t::create_callback_container();
+    std::atomic<int> calls{0};
+    auto permanent = container->register_callback([&calls]() { ++calls; });
+    std::atomic<bool> done{false};
+    std::vector<std::future<void>> dispatchers;
+    for (auto i = 0; i < dispatchersCount; ++i)
+    {
+        dispatchers.push_back(std::async(std::launch::async, [&]() {
+            while (!done)
+            {
+                (*container)();
+            }
+        }));
+    }
+
+    while (calls == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    // unregister waits for the running calls, i.e. no call can see the flag set
+    std::atomic<bool> unregistered{false};
+    std::atomic<int> callsAfterUnregister{0};
+    for (auto i = 0; i < registrationsCount; ++i)
+    {
+        unregistered = false;
+        auto token = container->register_callback([&]() {
+            if (unregistered)
+            {
+                ++callsAfterUnregister;
+            }
+        });
+        token.unregister();
+        unregistered = true;
+    }
+
+    done = true;
+    for (auto& dispatcher : dispatchers)
+    {
+        dispatcher.get();
+    }
+    ASSERT_EQ(0, callsAfterUnregister);
+}
+
 TEST(CallbackContainerTest, IfRecursiveMutexIsUsedThreadSafeMethodsCanBeCalledFromCallbacks)
 {
     using container_t = callback_container<std::function<void(void)>, std::recursive_mutex>;
@@ -171,6 +256,27 @@ TEST(CallbackContainerTest, IfRecursiveMutexIsUsedThreadSafeMethodsCanBeCalledFr
     ASSERT_EQ(1, innerExecutedCount);
 }
 
+TEST(CallbackContainerTest, ThreadSafeMethodsCanBeCalledFromCallbacksWithExclusiveMutex)
+{
+    using container_t = callback_container<std::function<void(void)>, std::mutex>;
+
+    auto container = container_t::create_callback_container();
+    auto innerExecutedCount{0};
+    container_t::token_t innerToken;
+    container_t::token_t token;
+    auto callback = [&]() {
+        innerToken = container->register_callback([&]() { innerExecutedCount++; });
+        token.unregister();
+    };
+    token = container->register_callback(std::move(callback));
+
+    (*container)();
+    ASSERT_EQ(0, innerExecutedCount);
+
+    (*container)();
+    ASSERT_EQ(1, innerExecutedCount);
+}
+
 TEST(CallbackContainerTest, IfSharedMutexIsUsedCallbacksCanBeCalledAsynchronously)
 {
     static constexpr auto timeout = std::chrono::milliseconds(500);
@@ -246,4 +352,78 @@ TEST(CallbackContainerTest, IfSharedMutexIsUsedCallbacksCanBeCalledAsynchronousl
 
     ASSERT_TRUE(c1.wait_successful());
     ASSERT_TRUE(c2.wait_successful());
-}
\ No newline at end of file
+}
+
+TEST(CallbackContainerTest, WithExecutorCallbacksAreFiredOnTheExecutor)
+{
+    using container_t = callback_container<std::function<void(const std::string&)>>;
+
+    const auto executor = std::make_shared<bounded_executor>(1, 4, bounded_executor::overflow_policy::block);
+    auto container = container_t::create_callback_container(executor);
+    std::string received;
+    std::thread::id callbackThreadId;
+    auto token = container->register_callback([&](const std::string& value) {
+        received = value;
+        callbackThreadId = std::this_thread::get_id();
+    });
+
+    {
+        // the argument is copied, it does not need to outlive the call
+        const std::string value{"value"};
+        (*container)(value);
+    }
+    executor->wait_idle();
+
+    ASSERT_EQ("value", received);
+    ASSERT_NE(std::this_thread::get_id(), callbackThreadId);
+}
+
+TEST(CallbackContainerTest, WithExecutorPendingDispatchKeepsTheContainerAlive)
+{
+    using container_t = callback_container<std::function<void(int)>>;
+
+    const auto executor = std::make_shared<bounded_executor>(1, 4, bounded_executor::overflow_policy::block);
+    std::promise<void> release;
+    executor->post([released = release.get_future().share()]() { released.wait(); });
+
+    auto container = container_t::create_callback_container(executor);
+    std::weak_ptr<container_t> containerWeak = container;
+    auto called = 0;
+    auto token = container->register_callback([&called](int value) { called += value; });
+    (*container)(1);
+    container.reset();
+
+    ASSERT_FALSE(containerWeak.expired());
+    release.set_value();
+    executor->wait_idle();
+
+    ASSERT_EQ(1, called);
+    ASSERT_TRUE(containerWeak.expired());
+}
+
+TEST(CallbackContainerTest, WithExecutorContainerReleasedByTheRunningDispatchDoesNotOwnTheExecutor)
+{
+    using container_t = callback_container<std::function<void(int)>>;
+
+    auto executor = std::make_shared<bounded_executor>(1, 4, bounded_executor::overflow_policy::block);
+    auto container = container_t::create_callback_container(executor);
+    std::promise<void> called;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    auto token = container->register_callback([&](int) {
+        called.set_value();
+        released.wait();
+    });
+    (*container)(1);
+    called.get_future().wait();
+
+    // the running task holds the last reference to the container, it is released on the worker
+    container.reset();
+    auto releasing = std::async(std::launch::async, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.set_value();
+    });
+    // joins the worker, the container must not release the executor on the worker
+    ASSERT_NO_THROW(executor.reset());
+    releasing.get();
+}
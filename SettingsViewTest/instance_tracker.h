@@ -21,7 +21,7 @@ public:
     static void unregister_instance(const instance_t& instance)
     {
         const auto it
-            = std::find_if(m_instances.cbegin(), m_instances.cend(), [&](container_t::value_type item) { return &item.get() == &instance; });
+            = std::find_if(m_instances.cbegin(), m_instances.cend(), [&](typename container_t::value_type item) { return &item.get() == &instance; });
         m_instances.erase(it);
     }
 
@@ -0,0 +1,139 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <json_settings_loader.h>
+#include <settings_provider.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type input)
+        {
+            return input;
+        }
+    };
+
+    struct name
+    {
+        using source_type = std::string;
+        using value_type = std::string;
+
+        static constexpr auto path = "name";
+
+        static value_type parse(source_type&& input)
+        {
+            return std::move(input);
+        }
+    };
+}  // namespace
+
+TEST(JsonSettingsLoaderTest, ReadersAreInTheOrderOfTheFiles)
+{
+    std::vector<std::unique_ptr<temp_file>> files;
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < 12; ++i)
+    {
+        files.push_back(std::make_unique<temp_file>("{ \"index\" : " + std::to_string(i) + " }", std::to_string(i)));
+        fileNames.push_back(files.back()->path());
+    }
+
+    const json_settings_loader loader(4);
+    const auto readers = loader.load(fileNames);
+
+    ASSERT_EQ(fileNames.size(), readers.size());
+    for (std::size_t i = 0; i < readers.size(); ++i)
+    {
+        int index = -1;
+        readers[i]->get(index, "index");
+        ASSERT_EQ(static_cast<int>(i), index);
+    }
+}
+
+TEST(JsonSettingsLoaderTest, RepeatedLoadsOfTinyFilesComplete)
+{
+    std::vector<std::unique_ptr<temp_file>> files;
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < 8; ++i)
+    {
+        files.push_back(std::make_unique<temp_file>("{}", std::to_string(i)));
+        fileNames.push_back(files.back()->path());
+    }
+
+    // the tasks often finish before the load starts to wait, the completion must outlive their notification
+    const json_settings_loader loader(4);
+    for (int i = 0; i < 200; ++i)
+    {
+        ASSERT_EQ(fileNames.size(), loader.load(fileNames).size());
+    }
+}
+
+TEST(JsonSettingsLoaderTest, ErrorsOfAllTheFilesAreReported)
+{
+    const temp_file valid("{ \"age\" : 1 }", "valid");
+    const temp_file invalid("{ \"age\" : ", "invalid");
+    const temp_file notObject("[ 1, 2 ]", "notObject");
+
+    const json_settings_loader loader(2);
+    try
+    {
+        loader.load({invalid.path(), valid.path(), "missing.json", notObject.path()});
+        FAIL() << "the load did not throw";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        const std::string message = ex.what();
+        ASSERT_NE(std::string::npos, message.find("Cannot load settings file '" + invalid.path() + "': "));
+        ASSERT_NE(std::string::npos, message.find("Cannot load settings file 'missing.json': "));
+        ASSERT_NE(std::string::npos, message.find("Cannot load settings file '" + notObject.path() + "': Settings root is not an object"));
+        ASSERT_EQ(std::string::npos, message.find(valid.path()));
+    }
+}
+
+TEST(JsonSettingsLoaderTest, LaterFilesOverrideTheEarlierOnesInTheProvider)
+{
+    const temp_file defaults("{ \"age\" : 1, \"name\" : \"default\" }", "defaults");
+    const temp_file host("{ \"age\" : 2 }", "host");
+
+    const json_settings_loader loader;
+    settings_provider provider(loader.load_layered({defaults.path(), host.path()}));
+
+    const auto view = provider.get_view<age, name>("test");
+    ASSERT_EQ(2, view.get<age>());
+    ASSERT_EQ("default", view.get<name>());
+}
+
+TEST(JsonSettingsLoaderTest, ArraysAreReadableThroughTheLayers)
+{
+    const temp_file defaults(R"({ "weights" : [0.5, 1.5], "ports" : [80, 81, 82] })", "defaults");
+    const temp_file host(R"({ "ports" : [8080] })", "host");
+
+    const json_settings_loader loader;
+    const auto reader = loader.load_layered({defaults.path(), host.path()});
+
+    numeric_array<double> weights;
+    numeric_array<std::int64_t> ports;
+    std::int64_t port = 0;
+    reader->get(weights, "weights");
+    reader->get(ports, "ports");
+
+    ASSERT_EQ((numeric_array<double>{0.5, 1.5}), weights);
+    ASSERT_EQ((numeric_array<std::int64_t>{8080}), ports);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(port, "ports/1").error().code);
+}
+
+TEST(JsonSettingsLoaderTest, ZeroThreadsThrow)
+{
+    ASSERT_THROW(json_settings_loader(0), std::invalid_argument);
+}
@@ -0,0 +1,208 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <json_settings_reader.h>
+#include <memory_mapped_file.h>
+
+#include <rapidjson/document.h>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    const char* const settingsJson = R"({
+        "name" : "Filip",
+        "age" : 37,
+        "big" : 10000000000,
+        "ratio" : 0.5,
+        "enabled" : true,
+        "address" : { "city" : "Brno", "zip" : 60200 },
+        "work" : { "city" : "Praha", "zip" : 11000 },
+        "servers" : [ { "host" : "alpha" }, { "host" : "beta", "ports" : [ 80, 443 ] } ],
+        "a/b" : { "c~d" : 1 },
+        "quoted" : "say \"hi\""
+    })";
+
+    rapidjson::Document parse(const char* json)
+    {
+        rapidjson::Document document;
+        document.Parse(json);
+        return document;
+    }
+}  // namespace
+
+TEST(JsonSettingsReaderTest, ReadsValuesOfAllTypes)
+{
+    const json_settings_reader reader(parse(settingsJson));
+
+    std::string name;
+    int age = 0;
+    std::int64_t big = 0;
+    double ratio = 0;
+    bool enabled = false;
+    reader.get(name, "name");
+    reader.get(age, "age");
+    reader.get(big, "big");
+    reader.get(ratio, "ratio");
+    reader.get(enabled, "enabled");
+
+    ASSERT_EQ("Filip", name);
+    ASSERT_EQ(37, age);
+    ASSERT_EQ(10000000000, big);
+    ASSERT_EQ(0.5, ratio);
+    ASSERT_TRUE(enabled);
+}
+
+TEST(JsonSettingsReaderTest, BatchGetReportsAllErrors)
+{
+    const json_settings_reader reader(parse(settingsJson));
+
+    const settings_path missing{"address/street"};
+    const settings_path missingParent{"home/city"};
+    const settings_path notInt{"name"};
+    const settings_path notString{"big"};
+    const settings_path found{"age"};
+    int intValue = 0;
+    std::string stringValue;
+    const setting_request requests[] = {
+        {&missing, &intValue}, {&missingParent, &stringValue}, {&notInt, &intValue}, {&notString, &stringValue}, {&found, &intValue}};
+
+    try
+    {
+        reader.get(requests, std::size(requests));
+        FAIL() << "std::runtime_error expected";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        ASSERT_EQ("Member 'address/street' not found\nMember 'home/city' not found\nMember 'name' is not of type int\n"
+                  "Member 'big' is not of type string",
+                  std::string(ex.what()));
+    }
+    ASSERT_EQ(37, intValue);
+}
+
+TEST(JsonSettingsReaderTest, TryGetReturnsTheFirstFailure)
+{
+    const json_settings_reader reader(parse(settingsJson));
+
+    const settings_path found{"age"};
+    const settings_path notInt{"name"};
+    const settings_path missing{"address/street"};
+    int first = 0;
+    int second = 0;
+    int third = 0;
+    const setting_request requests[] = {{&found, &first}, {&notInt, &second}, {&missing, &third}};
+
+    const auto result = reader.try_get(requests, std::size(requests));
+
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(setting_errc::type_mismatch, result.error().code);
+    ASSERT_EQ(&notInt, result.error().path);
+    ASSERT_EQ(37, first);
+}
+
+TEST(JsonSettingsReaderTest, IndexResolvesMembersOfTheirOwnParent)
+{
+    const json_settings_reader reader(parse(settingsJson));
+
+    std::string homeCity;
+    std::string workCity;
+    int workZip = 0;
+    reader.get(homeCity, "address/city");
+    reader.get(workCity, "work/city");
+    reader.get(workZip, "work/zip");
+
+    ASSERT_EQ("Brno", homeCity);
+    ASSERT_EQ("Praha", workCity);
+    ASSERT_EQ(11000, workZip);
+
+    // the member of another object is not found in the parent without it
+    int zip = 0;
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(zip, settings_path{"zip"}).error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(zip, settings_path{"servers/0/zip"}).error().code);
+}
+
+TEST(JsonSettingsReaderTest, NestedPathWalksObjectsAndArrays)
+{
+    const json_settings_reader reader(parse(settingsJson));
+
+    std::string host;
+    int port = 0;
+    int escaped = 0;
+    reader.get(host, "servers/1/host");
+    reader.get(port, "servers/1/ports/1");
+    reader.get(escaped, "a~1b/c~0d");
+
+    ASSERT_EQ("beta", host);
+    ASSERT_EQ(443, port);
+    ASSERT_EQ(1, escaped);
+
+    // index out of the array, index of an object, member of an array and the path through a leaf
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(host, settings_path{"servers/2/host"}).error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(host, settings_path{"address/0"}).error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(host, settings_path{"servers/host"}).error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(host, settings_path{"name/first"}).error().code);
+}
+
+TEST(JsonSettingsReaderTest, TopLevelNameWithSpecialCharactersIsReadAsMember)
+{
+    const json_settings_reader reader(parse(R"({ "x~y" : 1, "x/y" : 2 })"));
+
+    int tilde = 0;
+    int slash = 0;
+    reader.get(tilde, settings_path::member("x~y"));
+    reader.get(slash, settings_path::member("x/y"));
+
+    ASSERT_EQ(1, tilde);
+    ASSERT_EQ(2, slash);
+}
+
+TEST(JsonSettingsReaderTest, FirstOfDuplicateMembersIsRead)
+{
+    const json_settings_reader reader(parse(R"({ "a" : 1, "nested" : { "b" : "first", "b" : "second" }, "a" : 2 })"));
+
+    int a = 0;
+    std::string b;
+    reader.get(a, "a");
+    reader.get(b, "nested/b");
+
+    ASSERT_EQ(1, a);
+    ASSERT_EQ("first", b);
+}
+
+TEST(JsonSettingsReaderTest, StringViewPointsToTheParsedFile)
+{
+    const temp_file file(settingsJson);
+    auto mappedFile = std::make_unique<memory_mapped_file>(file.path());
+    const std::string_view content(mappedFile->data(), mappedFile->size());
+    const json_settings_reader reader(std::move(mappedFile));
+
+    std::string_view city;
+    std::string_view quoted;
+    reader.get(city, "address/city");
+    reader.get(quoted, "quoted");
+
+    ASSERT_EQ("Brno", city);
+    ASSERT_GE(city.data(), content.data());
+    ASSERT_LE(city.data() + city.size(), content.data() + content.size());
+    // the escapes are decoded in place
+    ASSERT_EQ("say \"hi\"", quoted);
+    ASSERT_GE(quoted.data(), content.data());
+    ASSERT_LE(quoted.data() + quoted.size(), content.data() + content.size());
+}
+
+TEST(JsonSettingsReaderTest, InvalidDocumentThrows)
+{
+    const temp_file invalid("{ \"a\" : ");
+    const temp_file notObject("[ 1, 2 ]", ".array");
+
+    ASSERT_THROW(json_settings_reader{invalid.path()}, std::runtime_error);
+    ASSERT_THROW(json_settings_reader{notObject.path()}, std::runtime_error);
+    ASSERT_THROW(json_settings_reader{std::unique_ptr<memory_mapped_file>{}}, std::invalid_argument);
+}
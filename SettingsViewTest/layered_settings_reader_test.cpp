@@ -0,0 +1,329 @@
+#include "pch.h"
+
+#include <layered_settings_reader.h>
+#include <settings_provider.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using layer_t = std::map<std::string, setting_value>;
+    using arrays_t = std::map<std::string, numeric_array<double>>;
+
+    // layer of both the settings and the arrays
+    struct array_layer
+    {
+        layer_t values;
+        arrays_t arrays;
+    };
+
+    // in-memory layer, the keys are settings_path::key
+    // The arrays are enumerated as JSON does, i.e. the items as the settings of their own.
+    class map_settings_reader final : public settings_reader
+    {
+    public:
+        explicit map_settings_reader(layer_t values)
+            : m_values(std::move(values))
+        {
+        }
+
+        explicit map_settings_reader(array_layer layer)
+            : m_values(std::move(layer.values))
+            , m_arrays(std::move(layer.arrays))
+        {
+            for (const auto& array : m_arrays)
+            {
+                for (std::size_t i = 0; i < array.second.size(); ++i)
+                {
+                    m_values.emplace(array.first + settings_path::separator + std::to_string(i), array.second[i]);
+                }
+            }
+        }
+
+        void get(int&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not expected to be read from the layer");
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not expected to be read from the layer");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not expected to be read from the layer");
+        }
+
+        void get(numeric_array<double>& value, const settings_path& path) const override
+        {
+            const auto arrayIt = m_arrays.find(path.key());
+            if (arrayIt == m_arrays.end())
+            {
+                throw std::runtime_error("Member '" + path.str() + "' not found");
+            }
+            value = arrayIt->second;
+        }
+
+        void for_each(const visitor_t& visitor) const override
+        {
+            for (const auto& value : m_values)
+            {
+                visitor(value.first, value.second);
+            }
+        }
+
+        void for_each_array(const array_visitor_t& visitor) const override
+        {
+            for (const auto& array : m_arrays)
+            {
+                visitor(array.first);
+            }
+        }
+
+    private:
+        layer_t m_values;
+        arrays_t m_arrays;
+    };
+
+    // cannot enumerate its settings
+    class opaque_settings_reader final : public settings_reader
+    {
+    public:
+        void get(int& value, const settings_path&) const override
+        {
+            value = 0;
+        }
+
+        void get(std::string& value, const settings_path&) const override
+        {
+            value.clear();
+        }
+
+        void get(std::string_view& value, const settings_path&) const override
+        {
+            value = {};
+        }
+    };
+
+    struct pool_size
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "db/pool/size";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    template <typename... Layers>
+    std::unique_ptr<layered_settings_reader> make_layered(Layers&&... layers)
+    {
+        std::vector<std::unique_ptr<const settings_reader>> readers;
+        (readers.push_back(std::make_unique<map_settings_reader>(std::forward<Layers>(layers))), ...);
+        return std::make_unique<layered_settings_reader>(std::move(readers));
+    }
+}  // namespace
+
+TEST(LayeredSettingsReaderTest, LaterLayerOverridesTheEarlierOnes)
+{
+    const auto reader = make_layered(layer_t{{"age", 1}, {"name", std::string_view{"default"}}},
+                                     layer_t{{"age", 2}},
+                                     layer_t{{"age", 3}, {"city", std::string_view{"Brno"}}});
+
+    int age = 0;
+    std::string name;
+    std::string city;
+    reader->get(age, "age");
+    reader->get(name, "name");
+    reader->get(city, "city");
+
+    ASSERT_EQ(3, age);
+    ASSERT_EQ("default", name);
+    ASSERT_EQ("Brno", city);
+    ASSERT_EQ(3, reader->size());
+}
+
+TEST(LayeredSettingsReaderTest, LayersAreMergedPerSetting)
+{
+    const auto reader = make_layered(layer_t{{"db/pool/size", 10}, {"db/pool/timeout", 30}}, layer_t{{"db/pool/size", 20}});
+
+    int size = 0;
+    int timeout = 0;
+    reader->get(size, "/db/pool/size");
+    reader->get(timeout, "db/pool/timeout");
+
+    ASSERT_EQ(20, size);
+    ASSERT_EQ(30, timeout);
+}
+
+TEST(LayeredSettingsReaderTest, TypeOfTheWinningLayerIsUsed)
+{
+    const auto reader = make_layered(layer_t{{"port", 80}}, layer_t{{"port", std::string_view{"http"}}});
+
+    int port = 0;
+    std::string_view portName;
+    reader->get(portName, "port");
+
+    ASSERT_EQ("http", portName);
+    ASSERT_THROW(reader->get(port, "port"), std::runtime_error);
+}
+
+TEST(LayeredSettingsReaderTest, BatchGetReportsAllErrors)
+{
+    const auto reader = make_layered(layer_t{{"age", 1}}, layer_t{{"name", std::string_view{"Filip"}}});
+
+    int age = 0;
+    int name = 0;
+    int missing = 0;
+    const settings_path agePath{"age"};
+    const settings_path namePath{"name"};
+    const settings_path missingPath{"missing"};
+    const setting_request requests[] = {{&agePath, &age}, {&namePath, &name}, {&missingPath, &missing}};
+
+    try
+    {
+        reader->get(requests, std::size(requests));
+        FAIL() << "the batch get did not throw";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        ASSERT_STREQ("Member 'name' is not of type int\nMember 'missing' not found", ex.what());
+    }
+    ASSERT_EQ(1, age);
+}
+
+TEST(LayeredSettingsReaderTest, TryGetReturnsTheFirstFailure)
+{
+    const auto reader = make_layered(layer_t{{"age", 1}}, layer_t{{"name", std::string_view{"Filip"}}});
+
+    int age = 0;
+    int name = 0;
+    int missing = 0;
+    const settings_path agePath{"age"};
+    const settings_path namePath{"name"};
+    const settings_path missingPath{"missing"};
+    const setting_request requests[] = {{&agePath, &age}, {&namePath, &name}, {&missingPath, &missing}};
+
+    const auto result = reader->try_get(requests, std::size(requests));
+
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(setting_errc::type_mismatch, result.error().code);
+    ASSERT_EQ(&namePath, result.error().path);
+    ASSERT_EQ(1, age);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(missing, missingPath).error().code);
+    ASSERT_TRUE(reader->try_get(age, agePath).has_value());
+}
+
+TEST(LayeredSettingsReaderTest, ForEachEnumeratesTheWinningValues)
+{
+    const auto reader = make_layered(layer_t{{"age", 1}, {"name", std::string_view{"default"}}}, layer_t{{"age", 2}});
+
+    std::map<std::string, setting_value> values;
+    reader->for_each([&values](std::string_view key, const setting_value& value) { values.emplace(key, value); });
+
+    ASSERT_EQ((std::map<std::string, setting_value>{{"age", 2}, {"name", std::string_view{"default"}}}), values);
+}
+
+TEST(LayeredSettingsReaderTest, SettingReplacesTheWholeObjectOfTheEarlierLayers)
+{
+    const auto reader = make_layered(layer_t{{"db/host", std::string_view{"localhost"}}, {"db/port", 5432}, {"age", 1}},
+                                     layer_t{{"db", std::string_view{"sqlite"}}});
+
+    std::string db;
+    std::string host;
+    reader->get(db, "db");
+
+    ASSERT_EQ("sqlite", db);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(host, "db/host").error().code);
+    ASSERT_EQ(2, reader->size());
+}
+
+TEST(LayeredSettingsReaderTest, ObjectReplacesTheSettingOfTheEarlierLayers)
+{
+    const auto reader = make_layered(layer_t{{"db", std::string_view{"sqlite"}}},
+                                     layer_t{{"db/host", std::string_view{"localhost"}}},
+                                     layer_t{{"db/port", 5432}});
+
+    std::string db;
+    std::string host;
+    int port = 0;
+    reader->get(host, "db/host");
+    reader->get(port, "db/port");
+
+    ASSERT_EQ("localhost", host);
+    ASSERT_EQ(5432, port);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(db, "db").error().code);
+}
+
+TEST(LayeredSettingsReaderTest, ArrayIsReplacedAsAWhole)
+{
+    const auto reader = make_layered(array_layer{{}, {{"ports", {80, 81, 82}}}}, array_layer{{}, {{"ports", {90}}}});
+
+    numeric_array<double> ports;
+    double port = 0;
+    reader->get(ports, "ports");
+    reader->get(port, "ports/0");
+
+    ASSERT_EQ((numeric_array<double>{90}), ports);
+    ASSERT_EQ(90, port);
+    // the items of the shadowed longer array are dropped
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(port, "ports/2").error().code);
+    ASSERT_EQ(1, reader->size());
+}
+
+TEST(LayeredSettingsReaderTest, ArraysAreReadFromTheirLayers)
+{
+    const auto reader = make_layered(array_layer{{{"age", 1}}, {{"weights", {0.5, 1.5}}, {"ports", {80}}, {"limits", {1, 2}}}},
+                                     array_layer{{{"ports", 8080}, {"limits/max", 3}}, {{"scales", {2}}}});
+
+    numeric_array<double> weights;
+    numeric_array<double> scales;
+    numeric_array<double> ports;
+    int age = 0;
+    reader->get(weights, "weights");
+    reader->get(scales, "scales");
+
+    ASSERT_EQ((numeric_array<double>{0.5, 1.5}), weights);
+    ASSERT_EQ((numeric_array<double>{2}), scales);
+    // an array and a setting of the same key do not mix, whichever comes later wins
+    ASSERT_EQ(setting_errc::type_mismatch, reader->try_get(ports, "ports").error().code);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(ports, "limits").error().code);
+    ASSERT_EQ(setting_errc::not_found, reader->try_get(age, "limits/0").error().code);
+    ASSERT_EQ(setting_errc::type_mismatch, reader->try_get(age, "weights").error().code);
+
+    std::set<std::string> arrays;
+    reader->for_each_array([&arrays](std::string_view key) { arrays.emplace(key); });
+    ASSERT_EQ((std::set<std::string>{"scales", "weights"}), arrays);
+}
+
+TEST(LayeredSettingsReaderTest, InvalidLayersThrow)
+{
+    std::vector<std::unique_ptr<const settings_reader>> nullLayer;
+    nullLayer.push_back(nullptr);
+    ASSERT_THROW(layered_settings_reader{std::move(nullLayer)}, std::invalid_argument);
+
+    std::vector<std::unique_ptr<const settings_reader>> opaqueLayer;
+    opaqueLayer.push_back(std::make_unique<opaque_settings_reader>());
+    ASSERT_THROW(layered_settings_reader{std::move(opaqueLayer)}, std::logic_error);
+}
+
+TEST(LayeredSettingsReaderTest, RebuiltReaderIsPublishedByReload)
+{
+    settings_provider provider(make_layered(layer_t{{"db/pool/size", 10}}, layer_t{}));
+    ASSERT_EQ(10, provider.get_view<pool_size>("test").get<pool_size>());
+
+    // the override layer changed, e.g. an environment variable was set
+    provider.reload(make_layered(layer_t{{"db/pool/size", 10}}, layer_t{{"db/pool/size", 50}}));
+
+    ASSERT_EQ(50, provider.get_view<pool_size>("test").get<pool_size>());
+}
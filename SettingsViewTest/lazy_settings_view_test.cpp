@@ -0,0 +1,103 @@
+#include "pch.h"
+
+#include <lazy_settings_view.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<int> namesParsed{0};
+    std::atomic<int> limitsParsed{0};
+
+    struct name
+    {
+        using source_type = std::string;
+        using value_type = std::string;
+
+        static constexpr auto path = "name";
+
+        static value_type parse(source_type&& input)
+        {
+            ++namesParsed;
+            return std::move(input);
+        }
+    };
+
+    struct limit
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "limit";
+
+        static value_type parse(source_type input)
+        {
+            ++limitsParsed;
+            if (input < 0)
+            {
+                throw std::runtime_error("limit must not be negative");
+            }
+            return input;
+        }
+    };
+}  // namespace
+
+TEST(LazySettingsViewTest, SettingIsParsedByTheFirstGet)
+{
+    namesParsed = 0;
+    limitsParsed = 0;
+    const lazy_settings_view<name, limit> view(std::string{"Filip"}, 10);
+
+    ASSERT_FALSE(view.parsed<name>());
+    ASSERT_EQ(10, view.get<limit>());
+    ASSERT_EQ(10, view.get<limit>());
+
+    ASSERT_EQ(0, namesParsed);
+    ASSERT_EQ(1, limitsParsed);
+    ASSERT_FALSE(view.parsed<name>());
+    ASSERT_TRUE(view.parsed<limit>());
+}
+
+TEST(LazySettingsViewTest, CopiesShareTheParsedValues)
+{
+    namesParsed = 0;
+    const lazy_settings_view<name> view(std::string{"Filip"});
+    const auto copy = view;
+
+    ASSERT_EQ("Filip", copy.get<name>());
+    ASSERT_EQ(&copy.get<name>(), &view.get<name>());
+    ASSERT_EQ(1, namesParsed);
+}
+
+TEST(LazySettingsViewTest, ConcurrentFirstGetsParseOnce)
+{
+    namesParsed = 0;
+    const lazy_settings_view<name> view(std::string{"Filip"});
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&view]() { ASSERT_EQ("Filip", view.get<name>()); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(1, namesParsed);
+}
+
+TEST(LazySettingsViewTest, ParseFailureIsRethrownWithoutParsingAgain)
+{
+    limitsParsed = 0;
+    const lazy_settings_view<limit> view(-1);
+
+    ASSERT_THROW(view.get<limit>(), std::runtime_error);
+    ASSERT_THROW(view.get<limit>(), std::runtime_error);
+    ASSERT_EQ(1, limitsParsed);
+    ASSERT_TRUE(view.parsed<limit>());
+}
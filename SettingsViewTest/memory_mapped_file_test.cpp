@@ -0,0 +1,93 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <memory_mapped_file.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+TEST(MemoryMappedFileTest, ContentIsMappedAndTerminated)
+{
+    const std::string content{"{ \"name\" : \"Filip\" }"};
+    const temp_file file(content);
+
+    const memory_mapped_file mapped(file.path());
+
+    ASSERT_EQ(content.size(), mapped.size());
+    ASSERT_EQ(content, std::string(mapped.data(), mapped.size()));
+    ASSERT_EQ('\0', mapped.data()[mapped.size()]);
+}
+
+TEST(MemoryMappedFileTest, ModificationDoesNotChangeTheFile)
+{
+    const std::string content{"abc"};
+    const temp_file file(content);
+
+    {
+        memory_mapped_file mapped(file.path());
+        mapped.data()[0] = 'x';
+        ASSERT_EQ('x', mapped.data()[0]);
+    }
+
+    const memory_mapped_file mapped(file.path());
+    ASSERT_EQ(content, std::string(mapped.data(), mapped.size()));
+}
+
+TEST(MemoryMappedFileTest, FileOfPageMultipleSizeIsTerminated)
+{
+    // 64 KiB is a multiple of any usual page size
+    const std::string content(64 * 1024, 'a');
+    const temp_file file(content);
+
+    const memory_mapped_file mapped(file.path());
+
+    ASSERT_EQ(content.size(), mapped.size());
+    ASSERT_EQ(content, std::string(mapped.data(), mapped.size()));
+    ASSERT_EQ('\0', mapped.data()[mapped.size()]);
+}
+
+TEST(MemoryMappedFileTest, EmptyFileIsTerminated)
+{
+    const temp_file file("");
+
+    const memory_mapped_file mapped(file.path());
+
+    ASSERT_EQ(0, mapped.size());
+    ASSERT_EQ('\0', mapped.data()[0]);
+}
+
+TEST(MemoryMappedFileTest, CopiedContentIsNotAffectedByTheFile)
+{
+    const std::string content{"{ \"name\" : \"Filip\" }"};
+    const temp_file file(content);
+
+    const memory_mapped_file copied(file.path(), memory_mapped_file::access::copy);
+    {
+        // truncated and rewritten in place, as an editor saving the file does
+        std::ofstream rewritten(file.path(), std::ios::binary | std::ios::trunc);
+        rewritten << "{}";
+    }
+
+    ASSERT_EQ(content, std::string(copied.data(), copied.size()));
+    ASSERT_EQ('\0', copied.data()[copied.size()]);
+}
+
+TEST(MemoryMappedFileTest, CopiedLargeFileIsReadWhole)
+{
+    const std::string content(200 * 1024 + 3, 'a');
+    const temp_file file(content);
+
+    const memory_mapped_file copied(file.path(), memory_mapped_file::access::copy);
+
+    ASSERT_EQ(content.size(), copied.size());
+    ASSERT_EQ(content, std::string(copied.data(), copied.size()));
+    ASSERT_EQ('\0', copied.data()[copied.size()]);
+}
+
+TEST(MemoryMappedFileTest, MissingFileThrows)
+{
+    ASSERT_THROW(memory_mapped_file("this file does not exist"), std::runtime_error);
+    ASSERT_THROW(memory_mapped_file("this file does not exist", memory_mapped_file::access::copy), std::runtime_error);
+}
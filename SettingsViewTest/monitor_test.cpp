@@ -14,6 +14,9 @@ namespace
 
     class test_mutex : private tracked<test_mutex>
     {
+        // the tracked base casts itself to the derived class
+        friend tracked<test_mutex>;
+
     public:
         test_mutex()
             : m_lock{lock_type::unlocked}
@@ -57,6 +60,8 @@ namespace
 
     class test_shared_mutex : private tracked<test_shared_mutex>
     {
+        friend tracked<test_shared_mutex>;
+
     public:
         test_shared_mutex()
             : m_lock{lock_type::unlocked}
@@ -0,0 +1,53 @@
+#include "pch.h"
+
+#include <numeric_array.h>
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+TEST(NumericArrayTest, BufferIsAligned)
+{
+    const numeric_array<double> array(3);
+
+    ASSERT_EQ(3u, array.size());
+    ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(array.data()) % numeric_array<double>::alignment);
+}
+
+TEST(NumericArrayTest, CopyCopiesTheItems)
+{
+    const numeric_array<std::int64_t> original{1, 2, 3};
+    numeric_array<std::int64_t> copy;
+    copy = original;
+
+    ASSERT_EQ(original, copy);
+    ASSERT_NE(original.data(), copy.data());
+
+    const auto moved = std::move(copy);
+    ASSERT_EQ(original, moved);
+    ASSERT_TRUE(copy.empty());
+}
+
+TEST(NumericArrayTest, ConvertNumbersIsExact)
+{
+    // more than a block, the tail and a block with integers out of the exact range of the fast path
+    std::vector<std::int64_t> source;
+    for (std::int64_t i = -40; i < 40; ++i)
+    {
+        source.push_back(i * 1000003);
+    }
+    source[50] = std::numeric_limits<std::int64_t>::max();
+    source[51] = std::numeric_limits<std::int64_t>::min();
+    source[52] = std::int64_t{1} << 51;
+    source[53] = -(std::int64_t{1} << 51);
+    source[54] = (std::int64_t{1} << 51) - 1;
+
+    numeric_array<double> converted(source.size());
+    convert_numbers(source.data(), source.size(), converted.data());
+
+    for (std::size_t i = 0; i < source.size(); ++i)
+    {
+        ASSERT_EQ(static_cast<double>(source[i]), converted[i]) << i;
+    }
+}
@@ -0,0 +1,166 @@
+#include "pch.h"
+
+#include <rcu_ptr.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(RcuPtrTest, LoadReturnsTheInitialValue)
+{
+    rcu_ptr<std::string> p{std::make_shared<const std::string>("first")};
+
+    ASSERT_EQ("first", *p.load());
+}
+
+TEST(RcuPtrTest, DefaultConstructedHoldsNull)
+{
+    rcu_ptr<int> p;
+
+    ASSERT_EQ(nullptr, p.load());
+}
+
+TEST(RcuPtrTest, LoadReturnsTheLastStoredValue)
+{
+    rcu_ptr<std::string> p{std::make_shared<const std::string>("first")};
+    p.store(std::make_shared<const std::string>("second"));
+    p.store(std::make_shared<const std::string>("third"));
+
+    ASSERT_EQ("third", *p.load());
+}
+
+TEST(RcuPtrTest, LoadedValueOutlivesTheStore)
+{
+    rcu_ptr<std::string> p{std::make_shared<const std::string>("first")};
+    const auto loaded = p.load();
+
+    p.store(std::make_shared<const std::string>("second"));
+
+    ASSERT_EQ("first", *loaded);
+    ASSERT_EQ("second", *p.load());
+}
+
+TEST(RcuPtrTest, ReplacedValueIsReleasedWhenNotLoaded)
+{
+    auto first = std::make_shared<const int>(1);
+    std::weak_ptr<const int> firstWeak = first;
+
+    rcu_ptr<int> p{std::move(first)};
+    p.store(std::make_shared<const int>(2));
+
+    ASSERT_TRUE(firstWeak.expired());
+}
+
+TEST(RcuPtrTest, UpdateReceivesTheCurrentValue)
+{
+    rcu_ptr<int> p{std::make_shared<const int>(41)};
+
+    const auto published = p.update([](const std::shared_ptr<const int>& current) { return std::make_shared<const int>(*current + 1); });
+
+    ASSERT_EQ(42, *published);
+    ASSERT_EQ(42, *p.load());
+}
+
+TEST(RcuPtrTest, ConcurrentReadersObserveOnlyPublishedValues)
+{
+    static constexpr auto readersCount = 4;
+    static constexpr auto updatesCount = 1000;
+
+    rcu_ptr<std::vector<int>> p{std::make_shared<const std::vector<int>>(16, 0)};
+    std::atomic<bool> done{false};
+
+    auto reader = [&]() {
+        auto consistent = true;
+        while (!done)
+        {
+            const auto value = p.load();
+            // all elements of a published value are equal
+            for (const auto item : *value)
+            {
+                consistent = consistent && item == value->front();
+            }
+        }
+        return consistent;
+    };
+
+    std::vector<std::future<bool>> readers;
+    for (auto i = 0; i < readersCount; ++i)
+    {
+        readers.push_back(std::async(std::launch::async, reader));
+    }
+
+    for (auto i = 1; i <= updatesCount; ++i)
+    {
+        p.update([i](const std::shared_ptr<const std::vector<int>>& current) {
+            return std::make_shared<const std::vector<int>>(current->size(), i);
+        });
+    }
+    done = true;
+
+    for (auto& r : readers)
+    {
+        ASSERT_TRUE(r.get());
+    }
+    ASSERT_EQ(updatesCount, p.load()->front());
+}
+
+namespace
+{
+    // counts the instances alive
+    struct counted final
+    {
+        explicit counted(std::atomic<int>& alive)
+            : m_alive{alive}
+        {
+            ++m_alive;
+        }
+
+        ~counted()
+        {
+            --m_alive;
+        }
+
+        std::atomic<int>& m_alive;
+    };
+}  // namespace
+
+TEST(RcuPtrTest, ReplacedValuesAreReleasedUnderContinuousReads)
+{
+    static constexpr auto readersCount = 8;
+    static constexpr auto updatesCount = 1000;
+
+    std::atomic<int> alive{0};
+    rcu_ptr<counted> p{std::make_shared<const counted>(alive)};
+    std::atomic<bool> done{false};
+
+    std::vector<std::future<void>> readers;
+    for (auto i = 0; i < readersCount; ++i)
+    {
+        readers.push_back(std::async(std::launch::async, [&]() {
+            while (!done)
+            {
+                p.load();
+            }
+        }));
+    }
+
+    auto maxAlive = 0;
+    for (auto i = 0; i < updatesCount; ++i)
+    {
+        p.store(std::make_shared<const counted>(alive));
+        maxAlive = std::max(maxAlive, alive.load());
+    }
+    done = true;
+    for (auto& r : readers)
+    {
+        r.get();
+    }
+
+    // the published value, each reader holds at most the value it loaded and the node it is copying it from
+    ASSERT_LE(maxAlive, 1 + 2 * readersCount);
+    p.store(std::make_shared<const counted>(alive));
+    ASSERT_EQ(1, alive);
+}
@@ -0,0 +1,89 @@
+#include "pch.h"
+
+#include <seqlock.h>
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <vector>
+
+TEST(SeqlockTest, ReadReturnsTheInitialValue)
+{
+    const monitor<int, seqlock> value{42};
+
+    ASSERT_EQ(42, value([](const int& v) { return v; }));
+}
+
+TEST(SeqlockTest, WriteIsVisibleToTheNextRead)
+{
+    monitor<int, seqlock> value{1};
+
+    value([](int& v) { v = 2; });
+
+    ASSERT_EQ(2, value([](const int& v) { return v; }));
+}
+
+TEST(SeqlockTest, WriteReturnsTheResultOfTheFunction)
+{
+    monitor<int, seqlock> value{1};
+
+    const auto previous = value([](int& v) { return v++; });
+
+    ASSERT_EQ(1, previous);
+    ASSERT_EQ(2, value([](const int& v) { return v; }));
+}
+
+TEST(SeqlockTest, ReadRetryDetectsInterferingWrite)
+{
+    seqlock lock;
+
+    const auto sequence = lock.read_begin();
+    ASSERT_FALSE(lock.read_retry(sequence));
+
+    lock.lock();
+    lock.unlock();
+
+    ASSERT_TRUE(lock.read_retry(sequence));
+}
+
+TEST(SeqlockTest, ConcurrentReadersNeverObserveTornValue)
+{
+    static constexpr auto readersCount = 4;
+    static constexpr auto writesCount = 10000;
+
+    // larger than a word, all the items are equal in each written value
+    using value_t = std::array<int, 8>;
+    monitor<value_t, seqlock> value{value_t{}};
+    std::atomic<bool> done{false};
+
+    auto reader = [&]() {
+        auto consistent = true;
+        while (!done)
+        {
+            const auto copy = value([](const value_t& v) { return v; });
+            for (const auto item : copy)
+            {
+                consistent = consistent && item == copy.front();
+            }
+        }
+        return consistent;
+    };
+
+    std::vector<std::future<bool>> readers;
+    for (auto i = 0; i < readersCount; ++i)
+    {
+        readers.push_back(std::async(std::launch::async, reader));
+    }
+
+    for (auto i = 1; i <= writesCount; ++i)
+    {
+        value([i](value_t& v) { v.fill(i); });
+    }
+    done = true;
+
+    for (auto& r : readers)
+    {
+        ASSERT_TRUE(r.get());
+    }
+    ASSERT_EQ(writesCount, value([](const value_t& v) { return v.back(); }));
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <json_settings_reader.h>
+#include <settings_file_watcher.h>
+#include <settings_provider.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    constexpr auto debounce = std::chrono::milliseconds(20);
+
+    void write_file(const std::string& path, const std::string& content)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+
+    // waits until the provider publishes the generation, false on timeout
+    bool wait_for_generation(const settings_provider& provider, settings_provider::generation_t generation)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (provider.generation() < generation)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        return true;
+    }
+
+    // the watched file is edited in place, i.e. it is not mapped
+    std::unique_ptr<json_settings_reader> read_file(const std::string& path)
+    {
+        return std::make_unique<json_settings_reader>(std::make_unique<memory_mapped_file>(path, memory_mapped_file::access::copy));
+    }
+
+    int age_value(settings_provider& provider)
+    {
+        return provider.get_view<age>("test").get<age>();
+    }
+}  // namespace
+
+TEST(SettingsFileWatcherTest, ChangedFileIsReloaded)
+{
+    const temp_file file(R"({ "age" : 1 })", ".json");
+    settings_provider provider(read_file(file.path()));
+    const settings_file_watcher watcher(provider, file.path(), debounce);
+
+    write_file(file.path(), R"({ "age" : 2 })");
+
+    ASSERT_TRUE(wait_for_generation(provider, 1));
+    ASSERT_EQ(2, age_value(provider));
+}
+
+TEST(SettingsFileWatcherTest, FileReplacedByRenameIsReloaded)
+{
+    const temp_file file(R"({ "age" : 1 })", ".json");
+    const temp_file replacement(R"({ "age" : 2 })", ".json.new");
+    settings_provider provider(read_file(file.path()));
+    const settings_file_watcher watcher(provider, file.path(), debounce);
+
+    std::filesystem::rename(replacement.path(), file.path());
+
+    ASSERT_TRUE(wait_for_generation(provider, 1));
+    ASSERT_EQ(2, age_value(provider));
+}
+
+TEST(SettingsFileWatcherTest, UnchangedContentIsNotReloaded)
+{
+    const temp_file file(R"({ "age" : 1 })", ".json");
+    settings_provider provider(read_file(file.path()));
+    const settings_file_watcher watcher(provider, file.path(), debounce);
+
+    write_file(file.path(), R"({ "age" : 1 })");
+    std::this_thread::sleep_for(debounce * 10);
+    write_file(file.path(), R"({ "age" : 2 })");
+
+    ASSERT_TRUE(wait_for_generation(provider, 1));
+    std::this_thread::sleep_for(debounce * 10);
+    // only the second write changed the content
+    ASSERT_EQ(1, provider.generation());
+}
+
+TEST(SettingsFileWatcherTest, InvalidFileLeavesPreviousSettings)
+{
+    const temp_file file(R"({ "age" : 1 })", ".json");
+    settings_provider provider(read_file(file.path()));
+    std::atomic<int> errorsCount{0};
+    const settings_file_watcher watcher(provider, file.path(), debounce, nullptr, [&errorsCount](const std::string&) { errorsCount++; });
+
+    write_file(file.path(), R"({ "age" : )");
+    std::this_thread::sleep_for(debounce * 10);
+
+    ASSERT_EQ(0, provider.generation());
+    ASSERT_EQ(1, age_value(provider));
+    ASSERT_EQ(1, errorsCount);
+
+    write_file(file.path(), R"({ "age" : 3 })");
+    ASSERT_TRUE(wait_for_generation(provider, 1));
+    ASSERT_EQ(3, age_value(provider));
+}
+
+TEST(SettingsFileWatcherTest, FactoryReadsTheHashedContent)
+{
+    const temp_file file(R"({ "age" : 1 })", ".json");
+    settings_provider provider(read_file(file.path()));
+    std::mutex contentsMtx;
+    std::vector<std::string> contents;
+    const settings_file_watcher watcher(provider,
+                                        file.path(),
+                                        debounce,
+                                        [&](const std::string& fileName, std::unique_ptr<memory_mapped_file>&& content) {
+                                            {
+                                                const std::lock_guard<std::mutex> lock(contentsMtx);
+                                                contents.emplace_back(content->data(), content->size());
+                                            }
+                                            // a write racing with the reload, it is not read by this reader
+                                            write_file(fileName, R"({ "age" : 3 })");
+                                            return std::make_unique<json_settings_reader>(std::move(content));
+                                        });
+
+    write_file(file.path(), R"({ "age" : 2 })");
+
+    // the racing write is not lost, it is reloaded by the next change
+    ASSERT_TRUE(wait_for_generation(provider, 2));
+    ASSERT_EQ(3, age_value(provider));
+    std::this_thread::sleep_for(debounce * 10);
+    ASSERT_EQ(2, provider.generation());
+
+    const std::lock_guard<std::mutex> lock(contentsMtx);
+    ASSERT_EQ((std::vector<std::string>{R"({ "age" : 2 })", R"({ "age" : 3 })"}), contents);
+}
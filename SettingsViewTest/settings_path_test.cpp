@@ -0,0 +1,96 @@
+#include "pch.h"
+
+#include <settings_path.h>
+
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    struct nested_setting
+    {
+        static constexpr auto path = "db/pool/size";
+    };
+}  // namespace
+
+TEST(SettingsPathTest, SingleTokenPath)
+{
+    const settings_path path{"name"};
+
+    ASSERT_EQ("name", path.str());
+    ASSERT_EQ(1, path.tokens().size());
+    ASSERT_EQ("name", path.tokens()[0].name);
+    ASSERT_EQ(std::hash<std::string_view>{}("name"), path.tokens()[0].hash);
+    ASSERT_EQ(settings_path::token::no_index, path.tokens()[0].index);
+}
+
+TEST(SettingsPathTest, NestedPathIsSplitBySeparator)
+{
+    const settings_path path{"db/pool/size"};
+
+    ASSERT_EQ(3, path.tokens().size());
+    ASSERT_EQ("db", path.tokens()[0].name);
+    ASSERT_EQ("pool", path.tokens()[1].name);
+    ASSERT_EQ("size", path.tokens()[2].name);
+}
+
+TEST(SettingsPathTest, LeadingSeparatorIsOptional)
+{
+    const settings_path path{"/db/pool"};
+
+    ASSERT_EQ("/db/pool", path.str());
+    ASSERT_EQ(2, path.tokens().size());
+    ASSERT_EQ("db", path.tokens()[0].name);
+}
+
+TEST(SettingsPathTest, EmptyPathHasNoTokens)
+{
+    ASSERT_TRUE(settings_path{""}.tokens().empty());
+    ASSERT_TRUE(settings_path{"/"}.tokens().empty());
+}
+
+TEST(SettingsPathTest, EscapeSequencesAreUnescaped)
+{
+    const settings_path path{"a~1b/c~0d"};
+
+    ASSERT_EQ(2, path.tokens().size());
+    ASSERT_EQ("a/b", path.tokens()[0].name);
+    ASSERT_EQ("c~d", path.tokens()[1].name);
+}
+
+TEST(SettingsPathTest, InvalidEscapeSequenceThrows)
+{
+    ASSERT_THROW(settings_path{"a~2"}, std::invalid_argument);
+    ASSERT_THROW(settings_path{"a~"}, std::invalid_argument);
+}
+
+TEST(SettingsPathTest, MemberNameIsTakenVerbatim)
+{
+    const auto path = settings_path::member("a/b~c");
+
+    ASSERT_EQ(1, path.tokens().size());
+    ASSERT_EQ("a/b~c", path.tokens()[0].name);
+    ASSERT_EQ("a~1b~0c", path.key());
+}
+
+TEST(SettingsPathTest, NumericTokensHaveIndex)
+{
+    const settings_path path{"hosts/12/0/01/x1"};
+
+    ASSERT_EQ(5, path.tokens().size());
+    ASSERT_EQ(12, path.tokens()[1].index);
+    ASSERT_EQ(0, path.tokens()[2].index);
+    ASSERT_EQ(settings_path::token::no_index, path.tokens()[3].index);
+    ASSERT_EQ(settings_path::token::no_index, path.tokens()[4].index);
+}
+
+TEST(SettingsPathTest, CompiledPathIsCreatedOnce)
+{
+    const auto& first = compiled_path<nested_setting>();
+    const auto& second = compiled_path<nested_setting>();
+
+    ASSERT_EQ(&first, &second);
+    ASSERT_EQ("db/pool/size", first.str());
+    ASSERT_EQ(3, first.tokens().size());
+}
@@ -0,0 +1,346 @@
+#include "pch.h"
+
+#include <settings_provider.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int countedReads = 0;
+
+    // int settings held in memory, counts the int reads
+    class map_settings_reader final : public settings_reader
+    {
+    public:
+        explicit map_settings_reader(std::map<std::string, int> values)
+            : m_values(std::move(values))
+        {
+        }
+
+        void get(int& value, const settings_path& path) const override
+        {
+            ++countedReads;
+            const auto valueIt = m_values.find(path.key());
+            if (valueIt == m_values.end())
+            {
+                throw std::runtime_error("Member '" + path.str() + "' not found");
+            }
+            value = valueIt->second;
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+    private:
+        std::map<std::string, int> m_values;
+    };
+
+    // reports every setting missing through the non-throwing settings_reader::read, the getters must not be called
+    class missing_settings_reader final : public settings_reader
+    {
+    public:
+        void get(int&, const settings_path&) const override
+        {
+            throw std::logic_error("get must not be called");
+        }
+
+        void get(std::string&, const settings_path&) const override
+        {
+            throw std::logic_error("get must not be called");
+        }
+
+        void get(std::string_view&, const settings_path&) const override
+        {
+            throw std::logic_error("get must not be called");
+        }
+
+    private:
+        std::optional<setting_errc> read(const setting_request&) const override
+        {
+            return setting_errc::not_found;
+        }
+    };
+
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct height
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "height";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct positive_height
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "height";
+
+        static value_type parse(source_type&& input)
+        {
+            if (input <= 0)
+            {
+                throw std::out_of_range("height must be positive");
+            }
+            return input;
+        }
+    };
+
+    int countedParses = 0;
+
+    // the same setting as age, counts its parse calls
+    struct counted_age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            ++countedParses;
+            return input;
+        }
+    };
+
+    std::unique_ptr<settings_reader> make_reader(std::map<std::string, int> values)
+    {
+        return std::make_unique<map_settings_reader>(std::move(values));
+    }
+}  // namespace
+
+TEST(SettingsProviderTest, ReloadPublishesNewGeneration)
+{
+    settings_provider provider(make_reader({{"age", 1}}));
+
+    ASSERT_EQ(1, provider.reload(make_reader({{"age", 2}})));
+
+    ASSERT_EQ(1, provider.generation());
+    ASSERT_EQ(2, provider.get_view<age>("test").get<age>());
+}
+
+TEST(SettingsProviderTest, ObserverReceivesTheDescriptorsOfTheView)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    std::string consumer;
+    std::vector<setting_descriptor> descriptors;
+    auto token = provider.add_observer([&](const std::string& name, setting_descriptors requested) {
+        consumer = name;
+        descriptors.assign(requested.begin(), requested.end());
+    });
+
+    provider.get_view<height, age>("test");
+
+    ASSERT_EQ("test", consumer);
+    ASSERT_EQ(2, descriptors.size());
+    ASSERT_EQ(type_id_v<height>, descriptors[0].id);
+    ASSERT_EQ("height", descriptors[0].path);
+    ASSERT_EQ(setting_kind::integer, descriptors[0].kind);
+    ASSERT_EQ(type_id_v<age>, descriptors[1].id);
+    ASSERT_EQ("age", descriptors[1].path);
+}
+
+TEST(SettingsProviderTest, DescriptorsAreSharedByAllCallsOfTheSamePack)
+{
+    settings_provider provider(make_reader({{"age", 1}}));
+    std::vector<const setting_descriptor*> notified;
+    auto token = provider.add_observer([&notified](const std::string&, setting_descriptors requested) { notified.push_back(requested.begin()); });
+
+    provider.get_view<age>("first");
+    provider.get_view<age>("second");
+
+    ASSERT_EQ(2, notified.size());
+    ASSERT_EQ(notified[0], notified[1]);
+    ASSERT_EQ(setting_descriptors_v<age>.data(), notified[0]);
+}
+
+TEST(SettingsProviderTest, SubscriberIsNotifiedWhenValueChanges)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    std::vector<int> notified;
+    auto token = provider.subscribe<age>([&notified](const int& value) { notified.push_back(value); });
+
+    provider.reload(make_reader({{"age", 2}, {"height", 180}}));
+
+    ASSERT_EQ((std::vector<int>{2}), notified);
+}
+
+TEST(SettingsProviderTest, SubscriberIsNotNotifiedWhenValueIsUnchanged)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    auto notifiedCount = 0;
+    auto token = provider.subscribe<age>([&notifiedCount](const int&) { notifiedCount++; });
+
+    // only the other setting changes
+    provider.reload(make_reader({{"age", 1}, {"height", 190}}));
+
+    ASSERT_EQ(0, notifiedCount);
+}
+
+TEST(SettingsProviderTest, AllSubscribersOfTheSettingAreNotified)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    auto ageCount = 0;
+    auto heightCount = 0;
+    auto firstToken = provider.subscribe<age>([&ageCount](const int&) { ageCount++; });
+    auto secondToken = provider.subscribe<age>([&ageCount](const int&) { ageCount++; });
+    auto heightToken = provider.subscribe<height>([&heightCount](const int&) { heightCount++; });
+
+    provider.reload(make_reader({{"age", 2}, {"height", 190}}));
+
+    ASSERT_EQ(2, ageCount);
+    ASSERT_EQ(1, heightCount);
+}
+
+TEST(SettingsProviderTest, UnsubscribedCallbackIsNotNotified)
+{
+    settings_provider provider(make_reader({{"age", 1}}));
+    auto notifiedCount = 0;
+    auto token = provider.subscribe<age>([&notifiedCount](const int&) { notifiedCount++; });
+
+    token.unregister();
+    provider.reload(make_reader({{"age", 2}}));
+
+    ASSERT_EQ(0, notifiedCount);
+}
+
+TEST(SettingsProviderTest, MissingSettingNotifiesWhenItReappears)
+{
+    settings_provider provider(make_reader({{"age", 1}}));
+    std::vector<int> notified;
+    auto token = provider.subscribe<age>([&notified](const int& value) { notified.push_back(value); });
+
+    provider.reload(make_reader({}));
+    provider.reload(make_reader({{"age", 1}}));
+
+    ASSERT_EQ((std::vector<int>{1}), notified);
+}
+
+TEST(SettingsProviderTest, LazyViewParsesEachSettingOncePerGeneration)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    countedParses = 0;
+
+    const auto first = provider.get_lazy_view<counted_age, height>("first");
+    const auto second = provider.get_lazy_view<counted_age, height>("second");
+    ASSERT_EQ(0, countedParses);
+
+    ASSERT_EQ(1, first.get<counted_age>());
+    ASSERT_EQ(1, second.get<counted_age>());
+    ASSERT_EQ(1, countedParses);
+    ASSERT_FALSE(second.parsed<height>());
+
+    provider.reload(make_reader({{"age", 2}, {"height", 180}}));
+    ASSERT_EQ(2, (provider.get_lazy_view<counted_age, height>("third").get<counted_age>()));
+    ASSERT_EQ(2, countedParses);
+}
+
+TEST(SettingsProviderTest, ViewIsParsedOncePerGeneration)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+    countedReads = 0;
+    countedParses = 0;
+
+    const auto first = provider.get_view<counted_age, height>("first");
+    const auto second = provider.get_view<counted_age, height>("second");
+    ASSERT_EQ(1, first.get<counted_age>());
+    ASSERT_EQ(1, second.get<counted_age>());
+    ASSERT_EQ(1, countedParses);
+    ASSERT_EQ(2, countedReads);
+
+    provider.reload(make_reader({{"age", 2}, {"height", 180}}));
+    const auto third = provider.get_view<counted_age, height>("third");
+    const auto fourth = provider.get_view<counted_age, height>("fourth");
+    ASSERT_EQ(2, third.get<counted_age>());
+    ASSERT_EQ(2, fourth.get<counted_age>());
+    ASSERT_EQ(2, countedParses);
+    ASSERT_EQ(4, countedReads);
+
+    // the view of the previous generation keeps its values
+    ASSERT_EQ(1, first.get<counted_age>());
+}
+
+TEST(SettingsProviderTest, LazyViewOfMissingSettingThrows)
+{
+    settings_provider provider(make_reader({{"age", 1}}));
+
+    ASSERT_THROW((provider.get_lazy_view<age, height>("test")), std::runtime_error);
+}
+
+TEST(SettingsProviderTest, TryGetViewReturnsTheViewOfReadableSettings)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 180}}));
+
+    const auto view = provider.try_get_view<age, height>("test");
+
+    ASSERT_TRUE(view.has_value());
+    ASSERT_EQ(180, view->get<height>());
+    // the same cached view as get_view returns
+    ASSERT_EQ(&view->get<age>(), &(provider.get_view<age, height>("test").get<age>()));
+}
+
+TEST(SettingsProviderTest, TryGetViewReturnsTheFailedSetting)
+{
+    settings_provider provider(make_reader({{"height", 180}}));
+
+    const auto failed = provider.try_get_view<height, age>("test");
+
+    ASSERT_FALSE(failed.has_value());
+    // map_settings_reader relies on the default settings_reader::try_get
+    ASSERT_EQ(setting_errc::unreadable, failed.error().code);
+    ASSERT_EQ(&compiled_path<age>(), failed.error().path);
+    ASSERT_THROW(failed.value(), std::runtime_error);
+}
+
+TEST(SettingsProviderTest, TryGetViewReadsThroughTheNonThrowingHook)
+{
+    settings_provider provider(std::make_unique<missing_settings_reader>());
+
+    const auto failed = provider.try_get_view<age>("test");
+
+    ASSERT_FALSE(failed.has_value());
+    ASSERT_EQ(setting_errc::not_found, failed.error().code);
+    ASSERT_EQ(&compiled_path<age>(), failed.error().path);
+}
+
+TEST(SettingsProviderTest, TryGetViewReportsInvalidSetting)
+{
+    settings_provider provider(make_reader({{"age", 1}, {"height", 0}}));
+
+    const auto view = provider.try_get_view<age, positive_height>("test");
+
+    ASSERT_FALSE(view.has_value());
+    ASSERT_EQ(setting_errc::invalid, view.error().code);
+    ASSERT_EQ(&compiled_path<positive_height>(), view.error().path);
+    ASSERT_EQ("Member 'height' is invalid", view.error().message());
+}
@@ -0,0 +1,236 @@
+#include "pch.h"
+
+#include <settings_provider.h>
+#include <settings_telemetry.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    class constant_settings_reader final : public settings_reader
+    {
+    public:
+        void get(int& value, const settings_path&) const override
+        {
+            value = 42;
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+    };
+
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct height
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "height";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+}  // namespace
+
+TEST(SettingsTelemetryTest, SmallValuesHaveExactBuckets)
+{
+    for (std::uint64_t value = 0; value < latency_histogram::sub_buckets_count; ++value)
+    {
+        ASSERT_EQ(value, latency_histogram::bucket_max(latency_histogram::bucket_index(value)));
+    }
+}
+
+TEST(SettingsTelemetryTest, BucketContainsTheValueWithinTheRelativeError)
+{
+    for (std::uint64_t value = 1; value < latency_histogram::max_value; value = value * 3 + 1)
+    {
+        const auto bucketMax = latency_histogram::bucket_max(latency_histogram::bucket_index(value));
+        ASSERT_LE(value, bucketMax);
+        ASSERT_LE(bucketMax - value, value / latency_histogram::sub_buckets_count);
+    }
+}
+
+TEST(SettingsTelemetryTest, ValuesAboveTheMaximumAreCountedInTheLastBucket)
+{
+    ASSERT_EQ(latency_histogram::buckets_count - 1, latency_histogram::bucket_index(latency_histogram::max_value));
+    ASSERT_EQ(latency_histogram::buckets_count - 1, latency_histogram::bucket_index(~std::uint64_t{0}));
+    ASSERT_EQ(latency_histogram::max_value, latency_histogram::bucket_max(latency_histogram::buckets_count - 1));
+}
+
+TEST(SettingsTelemetryTest, SummaryReportsThePercentiles)
+{
+    latency_histogram histogram;
+    for (std::uint64_t value = 1; value <= 100; ++value)
+    {
+        histogram.record(value);
+    }
+
+    latency_histogram::counts_t counts{};
+    histogram.add_to(counts);
+    const auto summary = latency_summary::from_counts(counts);
+
+    ASSERT_EQ(100, summary.count);
+    ASSERT_EQ(latency_histogram::bucket_max(latency_histogram::bucket_index(50)), summary.p50);
+    ASSERT_EQ(latency_histogram::bucket_max(latency_histogram::bucket_index(90)), summary.p90);
+    ASSERT_EQ(latency_histogram::bucket_max(latency_histogram::bucket_index(99)), summary.p99);
+    ASSERT_EQ(latency_histogram::bucket_max(latency_histogram::bucket_index(100)), summary.max);
+}
+
+TEST(SettingsTelemetryTest, ProviderRecordsTheAccessesOfEachConsumer)
+{
+    auto telemetry = std::make_shared<settings_telemetry>();
+    settings_provider provider(std::make_unique<constant_settings_reader>(), nullptr, telemetry);
+
+    provider.get_view<age, height>("first");
+    provider.get_view<age, height>("first");
+    provider.get_view<age>("second");
+    const auto report = telemetry->report();
+
+    ASSERT_EQ(3, report.accesses.size());
+    ASSERT_EQ("first", report.accesses[0].consumer);
+    ASSERT_EQ("age", report.accesses[0].path);
+    ASSERT_EQ(2, report.accesses[0].count);
+    ASSERT_EQ("first", report.accesses[1].consumer);
+    ASSERT_EQ("height", report.accesses[1].path);
+    ASSERT_EQ(2, report.accesses[1].count);
+    ASSERT_EQ("second", report.accesses[2].consumer);
+    ASSERT_EQ("age", report.accesses[2].path);
+    ASSERT_EQ(1, report.accesses[2].count);
+    ASSERT_EQ(3, report.viewLatency.count);
+    // the views are cached, the reader is used once per view type
+    ASSERT_EQ(2, report.readLatency.count);
+}
+
+TEST(SettingsTelemetryTest, ReloadedReaderIsInstrumented)
+{
+    auto telemetry = std::make_shared<settings_telemetry>();
+    settings_provider provider(std::make_unique<constant_settings_reader>(), nullptr, telemetry);
+
+    provider.get_view<age>("test");
+    provider.reload(std::make_unique<constant_settings_reader>());
+    provider.get_view<age>("test");
+
+    ASSERT_EQ(2, telemetry->report().readLatency.count);
+}
+
+TEST(SettingsTelemetryTest, ConcurrentRecordsAreMerged)
+{
+    static constexpr auto threadsCount = 4;
+    static constexpr auto recordsCount = 1000;
+
+    settings_telemetry telemetry;
+    std::vector<std::future<void>> writers;
+    for (auto i = 0; i < threadsCount; ++i)
+    {
+        writers.push_back(std::async(std::launch::async, [&telemetry]() {
+            for (auto j = 0; j < recordsCount; ++j)
+            {
+                telemetry.record_view("test", setting_descriptors_of<age>(), std::chrono::nanoseconds{j});
+                telemetry.record_read(std::chrono::nanoseconds{j});
+            }
+        }));
+    }
+    for (auto& writer : writers)
+    {
+        writer.get();
+    }
+    const auto report = telemetry.report();
+
+    ASSERT_EQ(threadsCount * recordsCount, report.viewLatency.count);
+    ASSERT_EQ(threadsCount * recordsCount, report.readLatency.count);
+    ASSERT_EQ(1, report.accesses.size());
+    ASSERT_EQ(threadsCount * recordsCount, report.accesses[0].count);
+}
+
+TEST(SettingsTelemetryTest, ReportDoesNotWaitForTheRecords)
+{
+    static constexpr auto threadsCount = 4;
+    static constexpr auto consumersCount = 100;
+    static constexpr auto roundsCount = 100;
+
+    settings_telemetry telemetry;
+    std::atomic<bool> done{false};
+    std::vector<std::future<void>> writers;
+    for (auto i = 0; i < threadsCount; ++i)
+    {
+        writers.push_back(std::async(std::launch::async, [&telemetry]() {
+            for (auto j = 0; j < roundsCount; ++j)
+            {
+                // more consumers than the initial capacity of the per-thread counters
+                for (auto k = 0; k < consumersCount; ++k)
+                {
+                    telemetry.record_view("consumer" + std::to_string(k), setting_descriptors_of<age>(), std::chrono::nanoseconds{j});
+                }
+            }
+        }));
+    }
+    auto reporter = std::async(std::launch::async, [&telemetry, &done]() {
+        while (!done.load())
+        {
+            const auto report = telemetry.report();
+            ASSERT_LE(report.accesses.size(), consumersCount);
+        }
+    });
+    for (auto& writer : writers)
+    {
+        writer.get();
+    }
+    done = true;
+    reporter.get();
+    const auto report = telemetry.report();
+
+    ASSERT_EQ(threadsCount * consumersCount * roundsCount, report.viewLatency.count);
+    ASSERT_EQ(consumersCount, report.accesses.size());
+    for (const auto& access : report.accesses)
+    {
+        ASSERT_EQ(threadsCount * roundsCount, access.count);
+    }
+}
+
+TEST(SettingsTelemetryTest, ReportIsExportedAsText)
+{
+    telemetry_report report{{{"main", "age", 3}}, {1, 2, 3, 4, 5}, {}};
+
+    ASSERT_EQ("get_view latency [ns]: count 1, p50 2, p90 3, p99 4, max 5\n"
+              "settings_reader::get latency [ns]: count 0, p50 0, p90 0, p99 0, max 0\n"
+              "consumer 'main' read 'age': 3\n",
+              report.to_text());
+}
+
+TEST(SettingsTelemetryTest, ReportIsExportedAsJson)
+{
+    telemetry_report report{{{"a\"b", "age", 3}, {"c", "x\\y", 1}}, {1, 2, 3, 4, 5}, {}};
+
+    ASSERT_EQ("{\"view_latency\": {\"count\": 1, \"p50\": 2, \"p90\": 3, \"p99\": 4, \"max\": 5}, "
+              "\"read_latency\": {\"count\": 0, \"p50\": 0, \"p90\": 0, \"p99\": 0, \"max\": 0}, "
+              "\"accesses\": [{\"consumer\": \"a\\\"b\", \"path\": \"age\", \"count\": 3}, "
+              "{\"consumer\": \"c\", \"path\": \"x\\\\y\", \"count\": 1}]}",
+              report.to_json());
+}
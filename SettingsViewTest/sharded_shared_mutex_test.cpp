@@ -0,0 +1,96 @@
+#include "pch.h"
+
+#include <callback_container.h>
+#include <monitor.h>
+#include <sharded_shared_mutex.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+TEST(ShardedSharedMutexTest, IsDetectedAsSharedMutex)
+{
+    ASSERT_TRUE(has_lock_shared_method_v<sharded_shared_mutex>);
+}
+
+TEST(ShardedSharedMutexTest, SharedLocksDoNotExcludeEachOther)
+{
+    sharded_shared_mutex mtx;
+
+    std::shared_lock<sharded_shared_mutex> first{mtx};
+    auto second = std::async(std::launch::async, [&mtx]() { return mtx.try_lock_shared() && (mtx.unlock_shared(), true); });
+
+    ASSERT_TRUE(second.get());
+    ASSERT_FALSE(mtx.try_lock());
+}
+
+TEST(ShardedSharedMutexTest, ExclusiveLockExcludesReaders)
+{
+    sharded_shared_mutex mtx;
+
+    std::unique_lock<sharded_shared_mutex> lock{mtx};
+    auto reader = std::async(std::launch::async, [&mtx]() { return mtx.try_lock_shared(); });
+
+    ASSERT_FALSE(reader.get());
+    lock.unlock();
+    ASSERT_TRUE(mtx.try_lock_shared());
+    mtx.unlock_shared();
+}
+
+TEST(ShardedSharedMutexTest, MonitorReadersNeverObserveHalfDoneWrite)
+{
+    static constexpr auto readersCount = 4;
+    static constexpr auto writesCount = 2000;
+
+    // both items are always equal outside of the writer
+    monitor<std::pair<int, int>, sharded_shared_mutex> value{};
+    std::atomic<bool> done{false};
+
+    auto reader = [&]() {
+        auto consistent = true;
+        while (!done)
+        {
+            consistent = consistent && value([](const std::pair<int, int>& v) { return v.first == v.second; });
+        }
+        return consistent;
+    };
+
+    std::vector<std::future<bool>> readers;
+    for (auto i = 0; i < readersCount; ++i)
+    {
+        readers.push_back(std::async(std::launch::async, reader));
+    }
+
+    for (auto i = 0; i < writesCount; ++i)
+    {
+        value([](std::pair<int, int>& v) {
+            ++v.first;
+            std::this_thread::yield();
+            ++v.second;
+        });
+    }
+    done = true;
+
+    for (auto& r : readers)
+    {
+        ASSERT_TRUE(r.get());
+    }
+    ASSERT_EQ(writesCount, value([](const std::pair<int, int>& v) { return v.first; }));
+}
+
+TEST(ShardedSharedMutexTest, CanBeUsedByCallbackContainer)
+{
+    using container_t = callback_container<std::function<void(void)>, sharded_shared_mutex>;
+
+    auto container = container_t::create_callback_container();
+    auto called = 0;
+    auto token = container->register_callback([&called]() { called++; });
+
+    (*container)();
+
+    ASSERT_EQ(1, called);
+}
@@ -0,0 +1,143 @@
+#include "pch.h"
+
+#include <slot_map.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<int> values(const slot_map<int>& map)
+    {
+        std::vector<int> result;
+        map.for_each([&result](int value) { result.push_back(value); });
+        return result;
+    }
+}  // namespace
+
+TEST(SlotMapTest, InsertedElementsAreVisited)
+{
+    slot_map<int> map;
+    map.insert(std::make_unique<const int>(1));
+    map.insert(std::make_unique<const int>(2));
+
+    ASSERT_EQ((std::vector<int>{1, 2}), values(map));
+}
+
+TEST(SlotMapTest, ErasedElementIsNotVisited)
+{
+    slot_map<int> map;
+    const auto first = map.insert(std::make_unique<const int>(1));
+    map.insert(std::make_unique<const int>(2));
+
+    ASSERT_TRUE(map.erase(first));
+    ASSERT_EQ((std::vector<int>{2}), values(map));
+}
+
+TEST(SlotMapTest, SlotOfErasedElementIsReused)
+{
+    slot_map<int> map;
+    const auto first = map.insert(std::make_unique<const int>(1));
+    map.erase(first);
+    const auto second = map.insert(std::make_unique<const int>(2));
+
+    ASSERT_EQ(first.index, second.index);
+    ASSERT_NE(first.generation, second.generation);
+}
+
+TEST(SlotMapTest, StaleHandleDoesNotEraseNewerElement)
+{
+    slot_map<int> map;
+    const auto first = map.insert(std::make_unique<const int>(1));
+    map.erase(first);
+    map.insert(std::make_unique<const int>(2));
+
+    ASSERT_FALSE(map.erase(first));
+    ASSERT_EQ((std::vector<int>{2}), values(map));
+}
+
+TEST(SlotMapTest, ElementsInsertedDuringIterationAreSkipped)
+{
+    slot_map<int> map;
+    map.insert(std::make_unique<const int>(1));
+
+    std::vector<int> visited;
+    map.for_each([&](int value) {
+        visited.push_back(value);
+        map.insert(std::make_unique<const int>(value + 1));
+    });
+
+    ASSERT_EQ((std::vector<int>{1}), visited);
+    ASSERT_EQ((std::vector<int>{1, 2}), values(map));
+}
+
+TEST(SlotMapTest, ElementErasedDuringIterationIsReleasedAfterIt)
+{
+    slot_map<std::shared_ptr<int>> map;
+    auto value = std::make_shared<int>(1);
+    std::weak_ptr<int> valueWeak = value;
+    const auto handle = map.insert(std::make_unique<const std::shared_ptr<int>>(std::move(value)));
+
+    map.for_each([&](const std::shared_ptr<int>& item) {
+        map.erase(handle);
+        // the element being called is not released yet
+        ASSERT_EQ(1, *item);
+        ASSERT_FALSE(valueWeak.expired());
+    });
+
+    ASSERT_TRUE(valueWeak.expired());
+}
+
+TEST(SlotMapTest, ErasedElementIsReleasedAfterItsCallOnAnotherThread)
+{
+    slot_map<std::shared_ptr<int>> map;
+    auto value = std::make_shared<int>(1);
+    std::weak_ptr<int> valueWeak = value;
+    const auto handle = map.insert(std::make_unique<const std::shared_ptr<int>>(std::move(value)));
+
+    std::promise<void> called;
+    std::promise<void> release;
+    auto reader = std::async(std::launch::async, [&]() {
+        map.for_each([&](const std::shared_ptr<int>&) {
+            called.set_value();
+            release.get_future().wait();
+        });
+    });
+    called.get_future().wait();
+
+    auto erasing = std::async(std::launch::async, [&]() { map.erase(handle); });
+    // the erase waits for the call in progress
+    ASSERT_EQ(std::future_status::timeout, erasing.wait_for(std::chrono::milliseconds(50)));
+    ASSERT_FALSE(valueWeak.expired());
+
+    release.set_value();
+    erasing.get();
+    ASSERT_TRUE(valueWeak.expired());
+    reader.get();
+}
+
+TEST(SlotMapTest, ElementsSpanMultipleSegments)
+{
+    static constexpr auto count = 1000;
+
+    slot_map<int> map;
+    std::vector<slot_handle> handles;
+    for (auto i = 0; i < count; ++i)
+    {
+        handles.push_back(map.insert(std::make_unique<const int>(i)));
+    }
+    for (auto i = 0; i < count; i += 2)
+    {
+        map.erase(handles[i]);
+    }
+
+    const auto visited = values(map);
+    ASSERT_EQ(count / 2, visited.size());
+    for (std::size_t i = 0; i < visited.size(); ++i)
+    {
+        ASSERT_EQ(static_cast<int>(2 * i + 1), visited[i]);
+    }
+}
@@ -0,0 +1,151 @@
+#include "pch.h"
+
+#include <static_settings_provider.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    // every int setting has the same value, counts the batch reads
+    class constant_settings_reader final : public settings_reader
+    {
+    public:
+        explicit constant_settings_reader(int value)
+            : m_value{value}
+            , m_reads{0}
+        {
+        }
+
+        void get(int& value, const settings_path&) const override
+        {
+            value = m_value;
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(const setting_request* requests, std::size_t count) const override
+        {
+            ++m_reads;
+            settings_reader::get(requests, count);
+        }
+
+        int reads() const
+        {
+            return m_reads;
+        }
+
+    private:
+        int m_value;
+        mutable std::atomic<int> m_reads;
+    };
+
+    // the single value getters hide the batch getter of the base class
+    class hiding_settings_reader final : public settings_reader
+    {
+    public:
+        void get(int&, const settings_path&) const override
+        {
+        }
+
+        void get(std::string&, const settings_path&) const override
+        {
+        }
+
+        void get(std::string_view&, const settings_path&) const override
+        {
+        }
+    };
+
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct name
+    {
+        using source_type = std::string;
+        using value_type = std::string;
+
+        static constexpr auto path = "name";
+
+        static value_type parse(source_type&& input)
+        {
+            return std::move(input);
+        }
+    };
+}  // namespace
+
+static_assert(is_settings_reader_v<constant_settings_reader>);
+static_assert(is_settings_reader_v<settings_reader>);
+static_assert(!is_settings_reader_v<hiding_settings_reader>);
+static_assert(!is_settings_reader_v<int>);
+
+TEST(StaticSettingsProviderTest, GetViewReadsTheSettings)
+{
+    static_settings_provider<constant_settings_reader> provider(std::make_unique<constant_settings_reader>(42));
+
+    const auto view = provider.get_view<age>();
+
+    ASSERT_EQ(42, view.get<age>());
+    ASSERT_EQ(0, provider.generation());
+}
+
+TEST(StaticSettingsProviderTest, ViewIsReadOncePerGeneration)
+{
+    auto reader = std::make_unique<constant_settings_reader>(42);
+    const auto& readerRef = *reader;
+    static_settings_provider<constant_settings_reader> provider(std::move(reader));
+
+    provider.get_view<age>();
+    provider.get_view<age>();
+
+    ASSERT_EQ(1, readerRef.reads());
+}
+
+TEST(StaticSettingsProviderTest, ReloadPublishesNewSettings)
+{
+    static_settings_provider<constant_settings_reader> provider(std::make_unique<constant_settings_reader>(1));
+    const auto before = provider.get_view<age>();
+
+    ASSERT_EQ(1, provider.reload(std::make_unique<constant_settings_reader>(2)));
+
+    ASSERT_EQ(1, before.get<age>());
+    ASSERT_EQ(2, provider.get_view<age>().get<age>());
+    ASSERT_EQ(1, provider.generation());
+}
+
+TEST(StaticSettingsProviderTest, FailedReadIsNotCached)
+{
+    static_settings_provider<constant_settings_reader> provider(std::make_unique<constant_settings_reader>(1));
+
+    ASSERT_THROW(provider.get_view<name>(), std::runtime_error);
+    ASSERT_THROW((provider.get_view<age, name>()), std::runtime_error);
+}
+
+TEST(StaticSettingsProviderTest, NullReaderThrows)
+{
+    ASSERT_THROW(static_settings_provider<constant_settings_reader>{nullptr}, std::invalid_argument);
+
+    static_settings_provider<constant_settings_reader> provider(std::make_unique<constant_settings_reader>(1));
+    ASSERT_THROW(provider.reload(nullptr), std::invalid_argument);
+}
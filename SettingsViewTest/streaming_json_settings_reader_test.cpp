@@ -0,0 +1,245 @@
+#include "pch.h"
+
+#include "temp_file.h"
+
+#include <settings_provider.h>
+#include <streaming_json_settings_reader.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    const char* const settingsJson = R"({
+        "name" : "Filip",
+        "age" : 37,
+        "big" : 10000000000,
+        "ratio" : 0.5,
+        "address" : { "city" : "Brno", "zip" : 60200 },
+        "servers" : [ { "host" : "alpha" }, { "host" : "beta" } ],
+        "a/b" : { "c~d" : 1 },
+        "skipped" : { "deep" : [ [ 1, 2 ], { "x" : null } ] }
+    })";
+
+    struct city
+    {
+        using source_type = std::string;
+        using value_type = std::string;
+
+        static constexpr auto path = "address/city";
+
+        static value_type parse(source_type&& input)
+        {
+            return std::move(input);
+        }
+    };
+
+    struct second_host
+    {
+        using source_type = std::string_view;
+        using value_type = std::string;
+
+        static constexpr auto path = "servers/1/host";
+
+        static value_type parse(source_type&& input)
+        {
+            return std::string(input);
+        }
+    };
+}  // namespace
+
+TEST(StreamingJsonSettingsReaderTest, ReadsTheRegisteredSettings)
+{
+    const temp_file file(settingsJson);
+    const streaming_json_settings_reader reader(file.path(), {"name", "age", "address/zip", "/servers/1/host", "a~1b/c~0d"});
+
+    std::string name;
+    int age = 0;
+    int zip = 0;
+    std::string_view host;
+    int escaped = 0;
+    reader.get(name, "name");
+    reader.get(age, "age");
+    reader.get(zip, "address/zip");
+    reader.get(host, "servers/1/host");
+    reader.get(escaped, "a~1b/c~0d");
+
+    ASSERT_EQ("Filip", name);
+    ASSERT_EQ(37, age);
+    ASSERT_EQ(60200, zip);
+    ASSERT_EQ("beta", host);
+    ASSERT_EQ(1, escaped);
+    ASSERT_EQ(5, reader.size());
+}
+
+TEST(StreamingJsonSettingsReaderTest, UnregisteredSettingsAreNotRead)
+{
+    const temp_file file(settingsJson);
+    const streaming_json_settings_reader reader(file.path(), {"age"});
+
+    std::string city;
+    ASSERT_THROW(reader.get(city, "address/city"), std::runtime_error);
+    ASSERT_EQ(1, reader.size());
+}
+
+TEST(StreamingJsonSettingsReaderTest, BatchGetReportsAllErrors)
+{
+    const temp_file file(settingsJson);
+    const streaming_json_settings_reader reader(file.path(), {"age", "name", "ratio", "missing"});
+
+    int age = 0;
+    int name = 0;
+    int ratio = 0;
+    int missing = 0;
+    const settings_path agePath{"age"};
+    const settings_path namePath{"name"};
+    const settings_path ratioPath{"ratio"};
+    const settings_path missingPath{"missing"};
+    const setting_request requests[] = {{&agePath, &age}, {&namePath, &name}, {&ratioPath, &ratio}, {&missingPath, &missing}};
+
+    try
+    {
+        reader.get(requests, std::size(requests));
+        FAIL() << "the batch get did not throw";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        // the real number is not narrowed to int
+        ASSERT_STREQ("Member 'name' is not of type int\nMember 'ratio' is not of type int\nMember 'missing' not found", ex.what());
+    }
+    ASSERT_EQ(37, age);
+}
+
+TEST(StreamingJsonSettingsReaderTest, NumbersAreReadAsTheWiderTypes)
+{
+    const temp_file file(settingsJson);
+    const streaming_json_settings_reader reader(file.path(), {"age", "big", "ratio"});
+
+    std::int64_t big = 0;
+    reader.get(big, "big");
+    ASSERT_EQ(10000000000, big);
+
+    double age = 0;
+    double ratio = 0;
+    reader.get(age, "age");
+    reader.get(ratio, "ratio");
+    ASSERT_EQ(37.0, age);
+    ASSERT_EQ(0.5, ratio);
+
+    int narrow = 0;
+    ASSERT_THROW(reader.get(narrow, "big"), std::runtime_error);
+}
+
+TEST(StreamingJsonSettingsReaderTest, FirstOfDuplicateMembersIsRead)
+{
+    const temp_file file(R"({ "age" : 1, "age" : 2, "name" : "x" })");
+    const streaming_json_settings_reader reader(file.path(), {"age", "name"});
+
+    int age = 0;
+    reader.get(age, "age");
+
+    ASSERT_EQ(1, age);
+}
+
+TEST(StreamingJsonSettingsReaderTest, ParsingStopsWhenAllSettingsAreFound)
+{
+    // the tail is not valid JSON
+    const temp_file file(R"({ "age" : 1, "rest" : [ 1, 2, )");
+    const streaming_json_settings_reader reader(file.path(), {"age"});
+
+    int age = 0;
+    reader.get(age, "age");
+
+    ASSERT_EQ(1, age);
+}
+
+TEST(StreamingJsonSettingsReaderTest, RegisteredArraysOfNumbersAreReadAsAWhole)
+{
+    const temp_file file(R"({
+        "weights" : [ 0.5, 1, 10000000000 ],
+        "tiers" : [ 10, 20 ],
+        "empty" : [],
+        "hosts" : [ "alpha", "beta" ],
+        "mixed" : [ 1, [ 2 ] ],
+        "skipped" : [ 1, 2 ]
+    })");
+    const streaming_json_settings_reader reader(file.path(), {"weights", "tiers", "tiers/1", "empty", "hosts", "mixed"});
+
+    numeric_array<double> weights;
+    numeric_array<std::int64_t> tiers;
+    numeric_array<double> empty{1};
+    std::int64_t tier = 0;
+    reader.get(weights, "weights");
+    reader.get(tiers, "tiers");
+    reader.get(empty, "empty");
+    reader.get(tier, "tiers/1");
+
+    ASSERT_EQ((numeric_array<double>{0.5, 1, 10000000000}), weights);
+    ASSERT_EQ((numeric_array<std::int64_t>{10, 20}), tiers);
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(20, tier);
+
+    numeric_array<std::int64_t> integers;
+    numeric_array<double> numbers;
+    int value = 0;
+    ASSERT_EQ(setting_errc::type_mismatch, reader.try_get(integers, "weights").error().code);
+    ASSERT_EQ(setting_errc::type_mismatch, reader.try_get(value, "tiers").error().code);
+    // only the arrays of numbers are collected
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(numbers, "hosts").error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(numbers, "mixed").error().code);
+    ASSERT_EQ(setting_errc::not_found, reader.try_get(numbers, "skipped").error().code);
+    ASSERT_EQ(4, reader.size());
+
+    std::vector<std::string> arrays;
+    reader.for_each_array([&arrays](std::string_view key) { arrays.emplace_back(key); });
+    std::sort(arrays.begin(), arrays.end());
+    ASSERT_EQ((std::vector<std::string>{"empty", "tiers", "weights"}), arrays);
+}
+
+TEST(StreamingJsonSettingsReaderTest, ItemsOfArraysKeepTheirParsedTypes)
+{
+    const temp_file file(R"({ "mixed" : [ 1, 10000000000, 0.5, 9007199254740993 ] })");
+    const streaming_json_settings_reader reader(file.path(), {"mixed"});
+
+    std::map<std::string, setting_value> items;
+    reader.for_each([&items](std::string_view key, const setting_value& value) { items.emplace(key, value); });
+
+    ASSERT_EQ(4, items.size());
+    ASSERT_EQ(setting_value{1}, items["mixed/0"]);
+    ASSERT_EQ(setting_value{std::int64_t{10000000000}}, items["mixed/1"]);
+    ASSERT_EQ(setting_value{0.5}, items["mixed/2"]);
+    // not rounded by the conversion of the array to double
+    ASSERT_EQ(setting_value{std::int64_t{9007199254740993}}, items["mixed/3"]);
+
+    numeric_array<double> numbers;
+    reader.get(numbers, "mixed");
+    ASSERT_EQ((numeric_array<double>{1, 10000000000, 0.5, 9007199254740993.0}), numbers);
+}
+
+TEST(StreamingJsonSettingsReaderTest, InvalidFileThrows)
+{
+    const temp_file invalid(R"({ "age" : 1, "rest" : [ 1, 2, )", "invalid");
+    const temp_file array("[ 1, 2 ]", "array");
+    const temp_file scalar("42", "scalar");
+
+    ASSERT_THROW(streaming_json_settings_reader(invalid.path(), {"name"}), std::runtime_error);
+    ASSERT_THROW(streaming_json_settings_reader(array.path(), {"name"}), std::runtime_error);
+    ASSERT_THROW(streaming_json_settings_reader(scalar.path(), {"name"}), std::runtime_error);
+    ASSERT_THROW(streaming_json_settings_reader(invalid.path() + ".missing", {"name"}), std::runtime_error);
+}
+
+TEST(StreamingJsonSettingsReaderTest, CreateRegistersThePathsOfTheSettingTypes)
+{
+    const temp_file file(settingsJson);
+    settings_provider provider(streaming_json_settings_reader::create<city, second_host>(file.path()));
+
+    const auto view = provider.get_view<city, second_host>("test");
+
+    ASSERT_EQ("Brno", view.get<city>());
+    ASSERT_EQ("beta", view.get<second_host>());
+}
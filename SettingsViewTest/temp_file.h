@@ -0,0 +1,37 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// creates a file with the given content in the temp directory and removes it at the end of the test
+// the file is named after the current test, the suffix distinguishes more files of the same test
+class temp_file final
+{
+public:
+    explicit temp_file(const std::string& content, const std::string& suffix = "")
+        : m_path{(std::filesystem::temp_directory_path() / (::testing::UnitTest::GetInstance()->current_test_info()->name() + suffix)).string()}
+    {
+        std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    temp_file(const temp_file&) = delete;
+    temp_file& operator=(const temp_file&) = delete;
+
+    ~temp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+
+    const std::string& path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
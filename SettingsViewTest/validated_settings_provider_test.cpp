@@ -0,0 +1,219 @@
+#include "pch.h"
+
+#include <validated_settings_provider.h>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+    // int settings held in memory, counts the reads
+    class map_settings_reader final : public settings_reader
+    {
+    public:
+        explicit map_settings_reader(std::map<std::string, int> values, int* readsCount = nullptr)
+            : m_values(std::move(values))
+            , m_readsCount{readsCount}
+        {
+        }
+
+        void get(int& value, const settings_path& path) const override
+        {
+            if (m_readsCount != nullptr)
+            {
+                ++*m_readsCount;
+            }
+
+            const auto valueIt = m_values.find(path.key());
+            if (valueIt == m_values.end())
+            {
+                throw std::runtime_error("Member '" + path.str() + "' not found");
+            }
+            value = valueIt->second;
+        }
+
+        void get(std::string&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+        void get(std::string_view&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type string");
+        }
+
+    private:
+        std::map<std::string, int> m_values;
+        int* m_readsCount;
+    };
+
+    struct age
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "age";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct height
+    {
+        using source_type = int;
+        using value_type = int;
+
+        static constexpr auto path = "height";
+
+        static value_type parse(source_type&& input)
+        {
+            if (input <= 0)
+            {
+                throw std::out_of_range("must be positive");
+            }
+            return input;
+        }
+    };
+
+    // a single string setting held in memory, the string_view points to it, flags the release
+    class text_settings_reader final : public settings_reader
+    {
+    public:
+        explicit text_settings_reader(std::string text, bool* released = nullptr)
+            : m_text(std::move(text))
+            , m_released{released}
+        {
+        }
+
+        ~text_settings_reader() override
+        {
+            if (m_released != nullptr)
+            {
+                *m_released = true;
+            }
+        }
+
+        void get(int&, const settings_path& path) const override
+        {
+            throw std::runtime_error("Member '" + path.str() + "' is not of type int");
+        }
+
+        void get(std::string& value, const settings_path&) const override
+        {
+            value = m_text;
+        }
+
+        void get(std::string_view& value, const settings_path&) const override
+        {
+            value = m_text;
+        }
+
+    private:
+        std::string m_text;
+        bool* m_released;
+    };
+
+    struct title
+    {
+        using source_type = std::string_view;
+        using value_type = std::string_view;
+
+        static constexpr auto path = "title";
+
+        static value_type parse(source_type&& input)
+        {
+            return input;
+        }
+    };
+
+    struct name
+    {
+        using source_type = std::string;
+        using value_type = std::string;
+
+        static constexpr auto path = "name";
+
+        static value_type parse(source_type&& input)
+        {
+            return std::move(input);
+        }
+    };
+
+    std::unique_ptr<settings_reader> make_reader(std::map<std::string, int> values, int* readsCount = nullptr)
+    {
+        return std::make_unique<map_settings_reader>(std::move(values), readsCount);
+    }
+}  // namespace
+
+TEST(ValidatedSettingsProviderTest, ViewsOfAnySubsetAreServedWithoutReading)
+{
+    int readsCount = 0;
+    const validated_settings_provider<age, height> provider(make_reader({{"age", 37}, {"height", 180}}, &readsCount));
+    const auto readsAfterValidation = readsCount;
+
+    static_assert(noexcept(provider.get_view<height>()));
+    const auto view = provider.get_view<height>();
+    const auto both = provider.get_view<height, age>();
+
+    ASSERT_EQ(180, view.get<height>());
+    ASSERT_EQ(37, both.get<age>());
+    ASSERT_EQ(&view.get<height>(), &both.get<height>());
+    ASSERT_EQ(readsAfterValidation, readsCount);
+}
+
+TEST(ValidatedSettingsProviderTest, AllInvalidSettingsAreReportedTogether)
+{
+    try
+    {
+        validated_settings_provider<age, height, name> provider(make_reader({{"height", -1}}));
+        FAIL() << "the construction did not throw";
+    }
+    catch (const std::runtime_error& ex)
+    {
+        ASSERT_STREQ("Member 'age' not found\n"
+                     "Member 'name' is not of type string\n"
+                     "Member 'height' is invalid: must be positive",
+                     ex.what());
+    }
+}
+
+TEST(ValidatedSettingsProviderTest, InvalidReloadKeepsThePreviousSettings)
+{
+    validated_settings_provider<age, height> provider(make_reader({{"age", 1}, {"height", 180}}));
+    const auto view = provider.get_view<age>();
+
+    ASSERT_THROW(provider.reload(make_reader({{"age", 2}})), std::runtime_error);
+    ASSERT_EQ(0, provider.generation());
+    ASSERT_EQ(1, provider.get_view<age>().get<age>());
+
+    ASSERT_EQ(1, provider.reload(make_reader({{"age", 2}, {"height", 170}})));
+    ASSERT_EQ(2, provider.get_view<age>().get<age>());
+    // the view of the previous generation stays valid
+    ASSERT_EQ(1, view.get<age>());
+}
+
+TEST(ValidatedSettingsProviderTest, StringViewSettingsStayValidWhileTheirViewExists)
+{
+    bool released = false;
+    validated_settings_provider<title> provider(std::make_unique<text_settings_reader>("first", &released));
+    {
+        const auto view = provider.get_view<title>();
+        ASSERT_EQ(1, provider.reload(std::make_unique<text_settings_reader>("second")));
+
+        ASSERT_FALSE(released);
+        ASSERT_EQ("first", view.get<title>());
+        ASSERT_EQ("second", provider.get_view<title>().get<title>());
+    }
+    // the reader of the previous generation is released with its last view
+    ASSERT_TRUE(released);
+}
+
+TEST(ValidatedSettingsProviderTest, NullReaderThrows)
+{
+    ASSERT_THROW(validated_settings_provider<age>(nullptr), std::invalid_argument);
+}